@@ -25,6 +25,7 @@
 #include "webserver/playlistaccess.h"
 #include "webserver/playeraccess.h"
 #include "webserver/wifiaccess.h"
+#include "webserver/federation.h"
 #include "playerinterface/mpvplayer.h"
 #include "playerinterface/gstplayer.h"
 #include "database/SimpleDatabase.h"
@@ -117,7 +118,9 @@ int main(int argc, char* argv[])
         file.dir = Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::AudioMp3);
         file.name = name.unique_id;
         file.extension = std::string(ServerConstant::mp3Extension);
-        return databaseWrapper.getDatabase()->addNewAudioFileUniqueId(file);
+        return databaseWrapper.updateDatabase([&file](Database::SimpleDatabase& database) {
+            return database.addNewAudioFileUniqueId(file);
+        });
     };
 
     /* handler to handle a web session call */
@@ -145,18 +148,39 @@ int main(int argc, char* argv[])
             logger(Level::info) << "end handler called for current song\n";
         };
         playerWrapper.setSongEndCB(std::move(songEndCallback));
+
+        // skipped songs are not counted as played
+        playerWrapper.setSongPlayedCB([&databaseWrapper](const boost::uuids::uuid& songID) {
+            databaseWrapper.playHistory().add(songID);
+        });
     }
 
     /* set session handler for different access points (mostly REST) */
 
+    /* searches are sent to the other audioserver instances as well, if configured */
+    Federation federation(ioc, config->m_peerList, config->m_peerTimeout);
+
     /* database access point */
-    sessionHandler.addUrlHandler(ServerConstant::AccessPoints::database, http::verb::get, PathCompare::exact,
-                                 [&databaseWrapper](const http::request_parser<http::string_body>& request) -> std::string {
-        if (auto url = utility::Extractor::getUrlInformation(request.get().target(), ServerConstant::AccessPoints::database))
-            return databaseWrapper.access(url);
-        else
+    sessionHandler.addAsyncUrlHandler(ServerConstant::AccessPoints::database, http::verb::get, PathCompare::exact,
+                                      [&databaseWrapper, &federation](const http::request_parser<http::string_body>& request,
+                                      Federation::ReplyHandler&& replyHandler) {
+        auto url = utility::Extractor::getUrlInformation(request.get().target(), ServerConstant::AccessPoints::database);
+        if (!url) {
             logger(Level::debug) << "url not set correctly\n";
-        return "";
+            replyHandler("");
+            return;
+        }
+
+        auto reply = databaseWrapper.access(url);
+
+        // a request of another instance is answered with the local result
+        bool fromPeer = request.get().find(std::string(ServerConstant::federationHeader)) != request.get().end();
+        if (!federation.enabled() || fromPeer || !DatabaseAccess::isFederated(url)) {
+            replyHandler(std::move(reply));
+            return;
+        }
+
+        federation.search(std::string(request.get().target()), std::move(reply), std::move(replyHandler));
     });
 
     /* playlist access point */
@@ -221,6 +245,26 @@ int main(int argc, char* argv[])
     /* start websocket handler */
     websocketSonginfoSenderTimer.start();
 
+    /* remove covers of deleted audio items from time to time */
+    RepeatTimer coverGarbageTimer(ioc, 10min);
+
+    coverGarbageTimer.setHandler([&databaseWrapper](){
+        databaseWrapper.updateDatabase([](Database::SimpleDatabase& database) {
+            return database.collectGarbage();
+        });
+    });
+
+    coverGarbageTimer.start();
+
+    /* write the plays collected so far to the play history */
+    RepeatTimer playHistoryTimer(ioc, 1min);
+
+    playHistoryTimer.setHandler([&databaseWrapper](){
+        databaseWrapper.playHistory().flush();
+    });
+
+    playHistoryTimer.start();
+
     /* one listener at a specific port can create/run multiple sessions */
     logger(Level::info) << "shared Listener creation and run\n";
     std::make_shared<Listener>(
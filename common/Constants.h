@@ -79,6 +79,12 @@ namespace ServerConstant {
         static const std::string hash{"Hash"};
         static const std::string hasCover{"HasCover"};
         static const std::string uidList{"UidList"};
+        static const std::string tracks{"Tracks"};
+        static const std::string albums{"Albums"};
+        static const std::string performers{"Performers"};
+        static const std::string playCount{"PlayCount"};
+        static const std::string lastPlayed{"LastPlayed"};
+        static const std::string peer{"Peer"};
         static const std::string playlist {"Playlist"};
         static const std::string playlists {"Playlists"};
         static const std::string currentPlaylist {"CurrentPlaylist"};
@@ -91,6 +97,8 @@ namespace ServerConstant {
             static const std::string logLevel {"LogLevel"};
             static const std::string amplify {"Amplify"};
             static const std::string audioInterface {"AudioInterface"};
+            static const std::string peers {"Peers"};
+            static const std::string peerTimeout {"PeerTimeout"};
             namespace PlayerType {
               static const std::string gstreamer {"gst"};
               static const std::string mpl {"mpl"};
@@ -134,6 +142,9 @@ namespace ServerConstant {
     static constexpr auto unknownCoverExtension {sv(".png")};
     static constexpr auto unknownCoverUrl {"img/unknown.png"};
 
+    // set on database requests of other instances, these are answered with the local result only
+    static constexpr auto federationHeader {sv("X-Audioserver-Federated")};
+
     namespace AccessPoints {
         static constexpr auto playlist {sv("/playlist")};
         static constexpr auto database {sv("/database")};
@@ -173,6 +184,17 @@ namespace ServerConstant {
             static constexpr auto playlist {sv("playlist")};
             static constexpr auto imageFile {sv("cover")};
             static constexpr auto url{sv("url")};
+            static constexpr auto complete {sv("complete")};
+            static constexpr auto session {sv("session")};
+            static constexpr auto limit {sv("limit")};
+            static constexpr auto cursor {sv("cursor")};
+            static constexpr auto sort {sv("sort")};
+            static constexpr auto duplicates {sv("duplicates")};
+            static constexpr auto cacheStatistics {sv("cacheStatistics")};
+            static constexpr auto facets {sv("facets")};
+            static constexpr auto changesSince {sv("changesSince")};
+            static constexpr auto mostPlayed {sv("mostPlayed")};
+            static constexpr auto recentlyPlayed {sv("recentlyPlayed")};
         }
         namespace Player {
             static constexpr auto next {sv("next")};
@@ -202,6 +224,21 @@ namespace ServerConstant {
     namespace Value {
         static constexpr auto _true {sv("true")};
         static constexpr auto _false {sv("false")};
+        namespace Sort {
+            static constexpr auto relevance {sv("relevance")};
+            static constexpr auto name {sv("name")};
+            static constexpr auto performer {sv("performer")};
+            static constexpr auto added {sv("added")};
+        }
+        namespace Duplicates {
+            static constexpr auto tags {sv("tags")};
+            static constexpr auto content {sv("content")};
+        }
+        namespace Facets {
+            static constexpr auto performer {sv("performer")};
+            static constexpr auto album {sv("album")};
+            static constexpr auto tag {sv("tag")};
+        }
     }
 
 
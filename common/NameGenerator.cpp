@@ -36,4 +36,12 @@ boost::uuids::uuid NameGenerator::createUuid() {
     return name;
 }
 
+boost::uuids::uuid NameGenerator::createUuid(const std::string &name) {
+    // namespace of all names generated by the audioserver
+    static const boost::uuids::uuid audioserverNamespace {
+        boost::uuids::string_generator()("b7ac2645-1667-46be-8000-000000000001") };
+    boost::uuids::name_generator_sha1 generator(audioserverNamespace);
+    return generator(name);
+}
+
 }
@@ -16,6 +16,8 @@ struct GenerationName {
 
 extern GenerationName create(const std::string& prefix, const std::string& suffix);
 extern boost::uuids::uuid createUuid();
+// the same name always gives the same uuid (name based, sha1)
+extern boost::uuids::uuid createUuid(const std::string& name);
 
 
 }
@@ -6,10 +6,12 @@
 #include <tuple>
 #include <boost/uuid/uuid.hpp>
 #include "id3tagreader/idtag.h"
+#include "common/NameGenerator.h"
 
 namespace Common {
 
 struct AlbumListEntry {
+    boost::uuids::uuid m_uid; //< derived from the album name, stable over restarts
     std::string m_name;
     std::string m_performer;
     std::string m_coverUrl;
@@ -17,6 +19,10 @@ struct AlbumListEntry {
     std::vector<std::tuple<boost::uuids::uuid, uint32_t>> m_playlist;
 };
 
+// uid of the album playlist for all tracks with this (normalized) album name
+inline boost::uuids::uuid albumPlaylistUid(const std::string& normalizedAlbum) {
+    return NameGenerator::createUuid("album:" + normalizedAlbum);
+}
 
 }
 
@@ -0,0 +1,18 @@
+#include "arena.h"
+
+#include <algorithm>
+
+using namespace Common;
+
+thread_local Arena* Arena::s_current { nullptr };
+
+void* Arena::allocateBlock(std::size_t bytes, std::size_t alignment) {
+
+    // a request bigger than a block gets a block of its own
+    auto blockSize = std::max(m_blockSize, bytes + alignment);
+    m_blockList.emplace_back(new char[blockSize]);
+    m_position = m_blockList.back().get();
+    m_available = blockSize;
+
+    return allocate(bytes, alignment);
+}
@@ -0,0 +1,92 @@
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <new>
+
+namespace Common {
+
+/*!
+ * \brief Arena hands out memory from a few big blocks and releases all of it at once,
+ * when it is destroyed. Single objects are never freed. It holds the temporary data of
+ * a bulk load (e.g. the json documents of the cache), that would otherwise be created
+ * and freed in many small heap allocations.
+ * ArenaAllocator takes its memory from the arena of the innermost Arena::Scope of the
+ * current thread, so containers using it must not outlive that arena.
+ */
+class Arena {
+
+    std::vector<std::unique_ptr<char[]>> m_blockList;
+    std::size_t m_blockSize;
+    char* m_position { nullptr };
+    std::size_t m_available { 0 };
+    std::size_t m_allocated { 0 };
+
+    static thread_local Arena* s_current;
+
+    void* allocateBlock(std::size_t bytes, std::size_t alignment);
+
+public:
+
+    static constexpr std::size_t defaultBlockSize { 1024*1024 };
+
+    explicit Arena(std::size_t blockSize = defaultBlockSize) : m_blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        std::size_t padding = (alignment - reinterpret_cast<std::size_t>(m_position) % alignment) % alignment;
+        if (padding + bytes > m_available)
+            return allocateBlock(bytes, alignment);
+        auto memory = m_position + padding;
+        m_position += padding + bytes;
+        m_available -= padding + bytes;
+        m_allocated += bytes;
+        return memory;
+    }
+
+    // bytes handed out so far and number of blocks taken from the heap for them
+    std::size_t allocated() const { return m_allocated; }
+    std::size_t blocks() const { return m_blockList.size(); }
+
+    // makes the arena the one used by ArenaAllocator on this thread, until the scope ends
+    class Scope {
+        Arena* m_previous;
+    public:
+        explicit Scope(Arena& arena) : m_previous(s_current) { s_current = &arena; }
+        ~Scope() { s_current = m_previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static Arena* current() { return s_current; }
+};
+
+template <typename T>
+struct ArenaAllocator {
+
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(std::size_t count) {
+        auto arena = Arena::current();
+        if (!arena)
+            throw std::bad_alloc();
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // memory is given back with the whole arena
+    void deallocate(T*, std::size_t) {}
+
+    friend bool operator==(const ArenaAllocator&, const ArenaAllocator&) { return true; }
+    friend bool operator!=(const ArenaAllocator&, const ArenaAllocator&) { return false; }
+};
+
+}
+
+#endif // COMMON_ARENA_H
@@ -32,6 +32,14 @@ void Common::Config::readConfig(std::string configFile) {
                 config->m_playerType = Common::Config::PlayerType::MpvPlayer;
         }
 
+        if (configData.find(ServerConstant::JsonField::Config::peers) != configData.end()) {
+            config->m_peerList = configData[ServerConstant::JsonField::Config::peers].get<std::vector<std::string>>();
+        }
+
+        if (configData.find(ServerConstant::JsonField::Config::peerTimeout) != configData.end()) {
+            config->m_peerTimeout = std::chrono::milliseconds(configData[ServerConstant::JsonField::Config::peerTimeout].get<uint32_t>());
+        }
+
         config->m_logLevel = LoggerFramework::Level::debug;
 
         if (debugLogLevel == ServerConstant::JsonField::Config::LogLevel::info) {
@@ -58,4 +66,6 @@ void Common::Config::print() {
     logger(LoggerFramework::Level::info) << "Amplifying with: " << m_amplify << "\n";
     logger(LoggerFramework::Level::info) << "Selected Internal Player: " << (m_playerType==PlayerType::unset?"<unset>":(m_playerType==PlayerType::GstPlayer?"Gstreamer Output":"MPL Output")) << "\n";
     logger(LoggerFramework::Level::info) << "With Cache: " << (m_enableCache?"yes":"no") << "\n";
+    for (const auto& peer : m_peerList)
+        logger(LoggerFramework::Level::info) << "Federated with: " << peer << " (timeout " << m_peerTimeout.count() << "ms)\n";
 }
@@ -2,6 +2,8 @@
 #define AUDIOSERVER_CONFIG_H
 
 #include <string>
+#include <vector>
+#include <chrono>
 #include <optional>
 #include <memory>
 #include "common/logger.h"
@@ -24,6 +26,10 @@ struct Config : std::enable_shared_from_this<Config> {
 
     bool m_enableCache {false};
 
+    // other audioserver instances ("host:port"), database searches are sent to them as well
+    std::vector<std::string> m_peerList;
+    std::chrono::milliseconds m_peerTimeout {1500};
+
     LoggerFramework::Level m_logLevel;
 
     bool isPlayerType(const PlayerType& playerType) const { return (playerType == m_playerType); }
@@ -32,6 +32,16 @@ inline std::size_t genHash(std::vector<char> const& _vec) {
     return seed;
 }
 
+// FNV-1a, stable over program runs (e.g. for checksums of files), continue with the last value as seed
+inline uint64_t genHash64(const void* data, std::size_t size, uint64_t seed = 0xcbf29ce484222325ULL) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t pos{0}; pos < size; ++pos) {
+        seed ^= bytes[pos];
+        seed *= 0x100000001b3ULL;
+    }
+    return seed;
+}
+
 }
 
 #endif // HASH_H
@@ -0,0 +1,41 @@
+#include "internedstring.h"
+
+using namespace Common;
+
+StringPool &StringPool::instance() {
+    static StringPool pool;
+    return pool;
+}
+
+const std::string* StringPool::intern(std::string_view value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // node based set: element addresses stay stable on rehash
+    auto it = m_strings.find(std::string(value));
+    if (it == std::end(m_strings))
+        it = m_strings.emplace(value).first;
+    return &(*it);
+}
+
+std::size_t StringPool::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_strings.size();
+}
+
+std::size_t StringPool::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // per node: the string, the next pointer and the cached hash value
+    constexpr std::size_t nodeOverhead { sizeof(void*) + sizeof(std::size_t) };
+
+    std::size_t bytes { m_strings.bucket_count() * sizeof(void*) };
+    for (const auto& value : m_strings)
+        bytes += stringMemory(value) + nodeOverhead;
+    return bytes;
+}
+
+std::size_t StringPool::stringMemory(const std::string& value) {
+    // short strings are kept inside the object (small string optimization)
+    std::string empty;
+    std::size_t heap = (value.capacity() > empty.capacity()) ? value.capacity() + 1 : 0;
+    return sizeof(std::string) + heap;
+}
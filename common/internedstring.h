@@ -0,0 +1,95 @@
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <mutex>
+#include <ostream>
+
+namespace Common {
+
+/*!
+ * \brief StringPool stores every distinct string once. Album names, performers and
+ * cover urls repeat for every track of an album, so the audio items only keep a
+ * pointer into this pool.
+ * Entries are never released, the pool only grows with new distinct strings.
+ */
+class StringPool {
+
+    std::unordered_set<std::string> m_strings;
+    mutable std::mutex m_mutex;
+
+    StringPool() = default;
+
+public:
+
+    static StringPool& instance();
+
+    // the returned pointer is valid for the lifetime of the program
+    const std::string* intern(std::string_view value);
+
+    std::size_t size() const;
+
+    // approximate heap and object memory held by the pool
+    std::size_t memoryUsage() const;
+
+    // memory a std::string with this content occupies (object and heap buffer)
+    static std::size_t stringMemory(const std::string& value);
+
+};
+
+/*!
+ * \brief InternedString is an immutable string stored in the StringPool.
+ * It is as small as a pointer and compares equal by pointer. Read access
+ * is given through str() or the implicit conversion to const std::string&.
+ */
+class InternedString {
+
+    const std::string* m_value;
+
+    static const std::string* emptyString() {
+        static const std::string* empty { StringPool::instance().intern("") };
+        return empty;
+    }
+
+public:
+
+    InternedString() : m_value(emptyString()) {}
+    InternedString(std::string_view value) : m_value(StringPool::instance().intern(value)) {}
+    InternedString(const std::string& value) : m_value(StringPool::instance().intern(value)) {}
+    InternedString(const char* value) : m_value(StringPool::instance().intern(value)) {}
+
+    InternedString& operator=(std::string_view value) { m_value = StringPool::instance().intern(value); return *this; }
+    InternedString& operator=(const std::string& value) { m_value = StringPool::instance().intern(value); return *this; }
+    InternedString& operator=(const char* value) { m_value = StringPool::instance().intern(value); return *this; }
+
+    const std::string& str() const { return *m_value; }
+    operator const std::string&() const { return *m_value; }
+
+    std::size_t length() const { return m_value->length(); }
+    std::size_t size() const { return m_value->size(); }
+    bool empty() const { return m_value->empty(); }
+    const char* c_str() const { return m_value->c_str(); }
+
+    std::size_t find(std::string_view what, std::size_t pos = 0) const { return m_value->find(what, pos); }
+    std::size_t find_last_of(char what) const { return m_value->find_last_of(what); }
+    std::string substr(std::size_t pos = 0, std::size_t count = std::string::npos) const { return m_value->substr(pos, count); }
+
+    friend bool operator==(const InternedString& a, const InternedString& b) { return a.m_value == b.m_value; }
+    friend bool operator!=(const InternedString& a, const InternedString& b) { return a.m_value != b.m_value; }
+    friend bool operator==(const InternedString& a, const std::string& b) { return *a.m_value == b; }
+    friend bool operator==(const std::string& a, const InternedString& b) { return a == *b.m_value; }
+    friend bool operator!=(const InternedString& a, const std::string& b) { return *a.m_value != b; }
+    friend bool operator!=(const std::string& a, const InternedString& b) { return a != *b.m_value; }
+    friend bool operator==(const InternedString& a, const char* b) { return *a.m_value == b; }
+    friend bool operator!=(const InternedString& a, const char* b) { return *a.m_value != b; }
+    friend bool operator<(const InternedString& a, const InternedString& b) { return *a.m_value < *b.m_value; }
+
+    friend std::ostream& operator<<(std::ostream& stream, const InternedString& value) { return stream << *value.m_value; }
+
+};
+
+}
+
+#endif // INTERNEDSTRING_H
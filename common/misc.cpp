@@ -181,20 +181,16 @@ void Common::audioserver_externalSelect(DatabaseAccess& databaseWrapper,
 
                     logger(Level::info) << "received album <" << albumName << "> and title <" << titleName << ">\n";
 
-                    const auto& albumPlaylists = databaseWrapper.getDatabase()->searchPlaylistItems(albumName);
+                    auto database = databaseWrapper.getDatabase();
 
-                    if (albumPlaylists.size() == 1) {
+                    if (auto albumPlaylist = database->findAlbumPlaylist(albumName)) {
                         logger(Level::info) << "album found\n";
-                        const std::string& title_low = Common::str_tolower(titleName);
-                        for (const auto& elem : databaseWrapper.getDatabase()->getIdListOfItemsInPlaylistId(albumPlaylists[0].getUniqueID())) {
+                        if (auto titleList = database->getSongInPlaylistByName(titleName, *albumPlaylist)) {
+                            logger(Level::info) << "External request found for <" << albumName << ":" << titleName
+                                                << "> - " << *albumPlaylist << " " << titleList->back() << "\n";
 
-                            if (elem.getNormalizedTitle() == title_low) {
-                                logger(Level::info) << "External request found for <" << albumName << ":" << titleName
-                                                    << "> - " << albumPlaylists[0].getUniqueID() << " " << elem.uid << "\n";
-
-                                albumId = albumPlaylists[0].getUniqueID();
-                                titleId = elem.uid;
-                            }
+                            albumId = *albumPlaylist;
+                            titleId = titleList->back();
                         }
                     }
                 }
@@ -203,7 +199,9 @@ void Common::audioserver_externalSelect(DatabaseAccess& databaseWrapper,
                 }
 
                 if (!albumId.is_nil() && !titleId.is_nil() ) {
-                    databaseWrapper.getDatabase()->setCurrentPlaylistUniqueId(std::move(albumId));
+                    databaseWrapper.updateDatabase([&albumId](Database::SimpleDatabase& database) {
+                        database.setCurrentPlaylistUniqueId(albumId);
+                    });
                     position = data.at(ServerConstant::SNC::position);
 
                     if (playerWrapper.hasPlayer()) {
@@ -233,23 +231,20 @@ void Common::audioserver_externalSelect(DatabaseAccess& databaseWrapper,
             const auto& albumName = std::string(request.at(ServerConstant::SNC::album));
             const auto& titleName = std::string(request.at(ServerConstant::SNC::title));
 
-            const auto& albumPlaylists = databaseWrapper.getDatabase()->searchPlaylistItems(albumName);
-
-            if (albumPlaylists.size() == 1) {
-                const std::string& title_low = Common::str_tolower(titleName);
-                for (const auto& elem : databaseWrapper.getDatabase()->getIdListOfItemsInPlaylistId(albumPlaylists[0].getUniqueID())) {
-
-                    if (elem.getNormalizedTitle() == title_low) {
-                        logger(Level::info) << "External request found for <"<<albumName<<":"<<titleName<<"> - "
-                                            << albumPlaylists[0].getUniqueID() << " " << elem.uid <<"\n";
-                        nlohmann::json msg;
-                        nlohmann::json reply;
-                        reply[ServerConstant::SNC::albumId] = boost::uuids::to_string(albumPlaylists[0].getUniqueID());
-                        reply[ServerConstant::SNC::titleId] = boost::uuids::to_string(elem.uid);
-                        msg[ServerConstant::SNC::CommandReply] = reply;
-                        if (sncClient)
-                            sncClient->send(snc::Client::SendType::cl_send, other, msg.dump());
-                    }
+            auto database = databaseWrapper.getDatabase();
+            auto albumPlaylist = database->findAlbumPlaylist(albumName);
+
+            if (albumPlaylist) {
+                for (const auto& titleId : database->getSongInPlaylistByName(titleName, *albumPlaylist).value_or(std::vector<boost::uuids::uuid>())) {
+                    logger(Level::info) << "External request found for <"<<albumName<<":"<<titleName<<"> - "
+                                        << *albumPlaylist << " " << titleId <<"\n";
+                    nlohmann::json msg;
+                    nlohmann::json reply;
+                    reply[ServerConstant::SNC::albumId] = boost::uuids::to_string(*albumPlaylist);
+                    reply[ServerConstant::SNC::titleId] = boost::uuids::to_string(titleId);
+                    msg[ServerConstant::SNC::CommandReply] = reply;
+                    if (sncClient)
+                        sncClient->send(snc::Client::SendType::cl_send, other, msg.dump());
                 }
             }
         }
@@ -1,7 +1,119 @@
 #include "stringmanipulator.h"
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 
+namespace {
+
+const std::array<char, 128> asciiFold = [] {
+    std::array<char, 128> table {};
+    for (std::size_t i{0}; i < table.size(); ++i)
+        table[i] = static_cast<char>((i >= 'A' && i <= 'Z') ? i + ('a' - 'A') : i);
+    return table;
+}();
+
+// latin letters with diacritics (latin-1 supplement and latin extended-a) and their search key
+struct FoldRange {
+    uint32_t first;
+    uint32_t last;
+    const char* folded;
+};
+
+constexpr FoldRange latinFold[] {
+    { 0x00C0, 0x00C5, "a" }, { 0x00C6, 0x00C6, "ae" }, { 0x00C7, 0x00C7, "c" }, { 0x00C8, 0x00CB, "e" },
+    { 0x00CC, 0x00CF, "i" }, { 0x00D0, 0x00D0, "d" }, { 0x00D1, 0x00D1, "n" }, { 0x00D2, 0x00D6, "o" },
+    { 0x00D8, 0x00D8, "o" }, { 0x00D9, 0x00DC, "u" }, { 0x00DD, 0x00DD, "y" }, { 0x00DE, 0x00DE, "th" },
+    { 0x00DF, 0x00DF, "ss" }, { 0x00E0, 0x00E5, "a" }, { 0x00E6, 0x00E6, "ae" }, { 0x00E7, 0x00E7, "c" },
+    { 0x00E8, 0x00EB, "e" }, { 0x00EC, 0x00EF, "i" }, { 0x00F0, 0x00F0, "d" }, { 0x00F1, 0x00F1, "n" },
+    { 0x00F2, 0x00F6, "o" }, { 0x00F8, 0x00F8, "o" }, { 0x00F9, 0x00FC, "u" }, { 0x00FD, 0x00FD, "y" },
+    { 0x00FE, 0x00FE, "th" }, { 0x00FF, 0x00FF, "y" },
+    { 0x0100, 0x0105, "a" }, { 0x0106, 0x010D, "c" }, { 0x010E, 0x0111, "d" }, { 0x0112, 0x011B, "e" },
+    { 0x011C, 0x0123, "g" }, { 0x0124, 0x0127, "h" }, { 0x0128, 0x0131, "i" }, { 0x0132, 0x0133, "ij" },
+    { 0x0134, 0x0135, "j" }, { 0x0136, 0x0138, "k" }, { 0x0139, 0x0142, "l" }, { 0x0143, 0x014B, "n" },
+    { 0x014C, 0x0151, "o" }, { 0x0152, 0x0153, "oe" }, { 0x0154, 0x0159, "r" }, { 0x015A, 0x0161, "s" },
+    { 0x0162, 0x0167, "t" }, { 0x0168, 0x0173, "u" }, { 0x0174, 0x0175, "w" }, { 0x0176, 0x0178, "y" },
+    { 0x0179, 0x017E, "z" }, { 0x017F, 0x017F, "s" }
+};
+
+// lowercase of greek and cyrillic letters (accented greek vowels without accent)
+uint32_t foldCodepoint(uint32_t codepoint) {
+    switch (codepoint) {
+    case 0x0386: case 0x03AC: return 0x03B1;
+    case 0x0388: case 0x03AD: return 0x03B5;
+    case 0x0389: case 0x03AE: return 0x03B7;
+    case 0x038A: case 0x03AF: return 0x03B9;
+    case 0x038C: case 0x03CC: return 0x03BF;
+    case 0x038E: case 0x03CD: return 0x03C5;
+    case 0x038F: case 0x03CE: return 0x03C9;
+    case 0x03C2: return 0x03C3;
+    default: break;
+    }
+    if (codepoint >= 0x0391 && codepoint <= 0x03A9)
+        return codepoint + 0x20;
+    if (codepoint >= 0x0410 && codepoint <= 0x042F)
+        return codepoint + 0x20;
+    if (codepoint >= 0x0400 && codepoint <= 0x040F)
+        return codepoint + 0x50;
+    return codepoint;
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+
+// decode one utf-8 sequence at position, the length is 0 for an invalid sequence
+uint32_t decodeUtf8(std::string_view text, std::size_t position, std::size_t& length) {
+    auto byte = [&text](std::size_t i) { return static_cast<unsigned char>(text[i]); };
+    auto lead = byte(position);
+    length = lead >= 0xF8 ? 0 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if (length == 0 || position + length > text.length()) {
+        length = 0;
+        return 0;
+    }
+    uint32_t codepoint = lead & (0x7F >> length);
+    for (std::size_t i{1}; i < length; ++i) {
+        if ((byte(position + i) & 0xC0) != 0x80) {
+            length = 0;
+            return 0;
+        }
+        codepoint = (codepoint << 6) | (byte(position + i) & 0x3F);
+    }
+    return codepoint;
+}
+
+// length of the pure ascii beginning of the text, checked 8 bytes at a time
+std::size_t asciiPrefix(std::string_view text) {
+    constexpr uint64_t highBits { 0x8080808080808080ULL };
+    std::size_t position {0};
+    for (; position + sizeof(uint64_t) <= text.length(); position += sizeof(uint64_t)) {
+        uint64_t block;
+        std::memcpy(&block, text.data() + position, sizeof(block));
+        if (block & highBits)
+            break;
+    }
+    while (position < text.length() && static_cast<unsigned char>(text[position]) < 0x80)
+        ++position;
+    return position;
+}
+
+}
+
 std::vector<std::string> Common::extractWhatList(const std::string &what)
 {
     // cut what string:
@@ -12,7 +124,7 @@ std::vector<std::string> Common::extractWhatList(const std::string &what)
         std::string whatItem;
         tmp >> whatItem;
         if (!whatItem.empty()) {
-            whatList.emplace_back(Common::str_tolower(whatItem));
+            whatList.emplace_back(Common::normalize(whatItem));
         }
     }
     return whatList;
@@ -25,3 +137,65 @@ std::string Common::str_tolower(std::string s)
     );
     return s;
 }
+
+std::string Common::normalize(std::string_view text)
+{
+    std::string key;
+    key.reserve(text.length());
+
+    // most names are ascii only, these are folded by table without decoding
+    auto position = asciiPrefix(text);
+    std::transform(text.begin(), text.begin() + position, std::back_inserter(key),
+                   [](char c) { return asciiFold[static_cast<unsigned char>(c)]; });
+
+    while (position < text.length()) {
+        auto value = static_cast<unsigned char>(text[position]);
+        if (value < 0x80) {
+            key.push_back(asciiFold[value]);
+            ++position;
+            continue;
+        }
+
+        std::size_t length;
+        auto codepoint = decodeUtf8(text, position, length);
+        if (length == 0) {
+            // not utf-8, keep the byte as is
+            key.push_back(text[position]);
+            ++position;
+            continue;
+        }
+        position += length;
+
+        // combining diacritical marks (decomposed accents) are dropped
+        if (codepoint >= 0x0300 && codepoint <= 0x036F)
+            continue;
+
+        auto fold = std::upper_bound(std::begin(latinFold), std::end(latinFold), codepoint,
+                                     [](uint32_t value, const FoldRange& range) { return value < range.first; });
+        if (fold != std::begin(latinFold) && codepoint <= std::prev(fold)->last) {
+            key.append(std::prev(fold)->folded);
+            continue;
+        }
+
+        appendUtf8(key, foldCodepoint(codepoint));
+    }
+
+    return key;
+}
+
+int Common::matchScore(const std::string &text, const std::string &what)
+{
+    if (what.empty())
+        return 0;
+
+    auto position = text.find(what);
+    if (position == std::string::npos)
+        return 0;
+    if (text.length() == what.length())
+        return 4;
+    if (position == 0)
+        return 3;
+    if (text.find(" " + what) != std::string::npos)
+        return 2;
+    return 1;
+}
@@ -2,6 +2,7 @@
 #define STRINGMANIPULATOR_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Common {
@@ -10,6 +11,15 @@ std::vector<std::string> extractWhatList(const std::string& what);
 
 std::string str_tolower(std::string s);
 
+/*
+ * search key of a text: utf-8 case folded and with the diacritics of latin letters removed
+ * ("Björk" and "BJORK" give "bjork"), all stored names and all search strings are normalized this way
+ */
+std::string normalize(std::string_view text);
+
+// how well the word matches the text: 4 equal, 3 at the beginning, 2 at a word start, 1 anywhere, 0 not found
+int matchScore(const std::string& text, const std::string& what);
+
 }
 
 #endif // STRINGMANIPULATOR_H
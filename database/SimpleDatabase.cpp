@@ -11,11 +11,11 @@ void SimpleDatabase::loadDatabase() {
     // some helper lambdas
     auto addPlaylistCover = [this](boost::uuids::uuid uid, 
             std::vector<char>&& data)
-    { m_id3Repository.addCover(std::move(uid), std::move(data)); };
+    { m_id3Repository.write().addCover(std::move(uid), std::move(data)); };
     
     auto findAudioIds = [this](const std::string& what, SearchItem searchItem) {
         std::vector<boost::uuids::uuid> uuidsFound;
-        auto list = m_id3Repository.search(what, searchItem, SearchAction::exact);
+        auto list = m_id3Repository->search(what, searchItem, SearchAction::exact);
         for(const auto& i : list) {
             uuidsFound.push_back(i.uid);
         }
@@ -25,65 +25,106 @@ void SimpleDatabase::loadDatabase() {
     /* gather all information together */
 
     logger(Level::info) << "Read audio id3 data from available files \n";
-    m_id3Repository.read();
+    m_id3Repository.write().read();
 
     logger(Level::info) << "Read M3U playlists - unfinished/empty method\n";
-    m_playlistContainer.readPlaylistsM3U();
+    m_playlistContainer.write().readPlaylistsM3U();
 
     logger(Level::info) << "Read json playlists\n";
-    m_playlistContainer.readPlaylistsJson(findAudioIds, addPlaylistCover);
-    m_playlistContainer.addTags({Tag::Playlist});
+    m_playlistContainer.write().readPlaylistsJson(findAudioIds, addPlaylistCover);
+    m_playlistContainer.write().addTags({Tag::Playlist});
 
     logger(Level::info) << "Auto create album playlists by audio items\n";
-    m_playlistContainer.insertAlbumPlaylists(m_id3Repository.extractAlbumList());
+    m_playlistContainer.write().insertAlbumPlaylists(m_id3Repository->extractAlbumList());
 
     logger(Level::info) << "Read information from tag file\n";
     songTagReader.readSongTagFile();
 
     logger(Level::info) << "Add tags to relevant item\n";
-    m_id3Repository.addTags(songTagReader);
+    m_id3Repository.write().addTags(songTagReader);
 
     logger(Level::info) << "Lift up tags from items to playlists\n";
-    m_playlistContainer.insertTagsFromItems(m_id3Repository);
+    m_playlistContainer.write().insertTagsFromItems(*m_id3Repository);
 
     logger(Level::info) << "Read Credentials\n";
     m_credentials.read();
 
 }
 
+void SimpleDatabase::seal() const {
+    m_id3Repository->seal();
+    m_playlistContainer->seal();
+}
+
 
-std::vector<Id3Info> SimpleDatabase::searchAudioItems(const std::string &what, SearchItem item, SearchAction action) {
-        return m_id3Repository.search(what, item, action);
+std::vector<Id3Info> SimpleDatabase::searchAudioItems(const std::string &what, SearchItem item, SearchAction action) const {
+        return m_id3Repository->search(what, item, action);
 }
 
-std::vector<Id3Info> SimpleDatabase::searchAudioItems(const boost::uuids::uuid &what, SearchItem item, SearchAction action) {
-        return m_id3Repository.search(what, item, action);
+std::vector<Id3Info> SimpleDatabase::searchAudioItems(const boost::uuids::uuid &what, SearchItem item, SearchAction action) const {
+        return m_id3Repository->search(what, item, action);
 }
 
-std::vector<Id3Info> SimpleDatabase::searchAudioItems(std::string_view what, SearchItem item, SearchAction action) {
+std::vector<Id3Info> SimpleDatabase::searchAudioItems(std::string_view what, SearchItem item, SearchAction action) const {
     return searchAudioItems(std::string(what), item, action);
 }
 
-std::vector<Id3Info> SimpleDatabase::searchAudioItems(const char *what, SearchItem item, SearchAction action) {
+std::vector<Id3Info> SimpleDatabase::searchAudioItems(const char *what, SearchItem item, SearchAction action) const {
     return searchAudioItems(std::string(what), item, action);
 }
 
-std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const std::string &what, SearchAction action) {
-    return  m_playlistContainer.searchPlaylists(what, action);
+std::vector<Id3Info> SimpleDatabase::searchAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const {
+    return m_id3Repository->search(criteriaList, action);
+}
+
+ResultList<Id3Info> SimpleDatabase::findAudioItems(const std::string &what, SearchItem item, SearchAction action) const {
+    return m_id3Repository->find(what, item, action);
+}
+
+ResultList<Id3Info> SimpleDatabase::findAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const {
+    return m_id3Repository->find(criteriaList, action);
 }
 
-std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const std::string_view &what, SearchAction action) {
-    return  m_playlistContainer.searchPlaylists(std::string(what), action);
+ResultList<Playlist> SimpleDatabase::findPlaylistItems(const std::string &what, SearchAction action) const {
+    return m_playlistContainer->findPlaylists(what, action);
 }
 
-std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const boost::uuids::uuid &what, SearchAction action) {
-    return  m_playlistContainer.searchPlaylists(what, action);
+ResultList<Id3Info> SimpleDatabase::findAudioItems(const std::string &what, SearchItem item, SearchAction action, const PageRequest &page) const {
+    return m_id3Repository->find(what, item, action, page);
+}
+
+ResultList<Id3Info> SimpleDatabase::findAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action, const PageRequest &page) const {
+    return m_id3Repository->find(criteriaList, action, page);
+}
+
+ResultList<Playlist> SimpleDatabase::findPlaylistItems(const std::string &what, SearchAction action, const PageRequest &page) const {
+    return m_playlistContainer->findPlaylists(what, action, page);
+}
+
+std::vector<std::string> SimpleDatabase::completeWords(const std::string &prefix, CompletionIndex::State &state) const {
+    return m_id3Repository->complete(prefix, state);
+}
+
+std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> SimpleDatabase::findDuplicates(DuplicateKey key) const {
+    return m_id3Repository->findDuplicates(key);
+}
+
+std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const std::string &what, SearchAction action) const {
+    return  m_playlistContainer->searchPlaylists(what, action);
+}
+
+std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const std::string_view &what, SearchAction action) const {
+    return  m_playlistContainer->searchPlaylists(std::string(what), action);
+}
+
+std::vector<Playlist> SimpleDatabase::searchPlaylistItems(const boost::uuids::uuid &what, SearchAction action) const {
+    return  m_playlistContainer->searchPlaylists(what, action);
 }
 
 
 std::optional<boost::uuids::uuid> SimpleDatabase::createPlaylist(const std::string &name, Persistent ) {
 
-    if (!m_playlistContainer.isUniqueName(name))
+    if (!m_playlistContainer->isUniqueName(name))
         return std::nullopt;
     return std::nullopt;
 // TODO
@@ -97,26 +138,25 @@ std::optional<boost::uuids::uuid> SimpleDatabase::createPlaylist(const std::stri
 //    return newPlaylistUniqueID.unique_id;
 }
 
-// create if not available
-std::optional<boost::uuids::uuid> SimpleDatabase::getTemporalPlaylistByName(const Id3Info &info) {
-
-    if (auto playlist = m_playlistContainer.getPlaylistByName(info.album_name)) {
-        return playlist->get().getUniqueID();
-    }
-
-    Playlist newPlaylist(Common::NameGenerator::createUuid(), std::vector<boost::uuids::uuid>());
-    newPlaylist.setName(info.album_name);
-    newPlaylist.setPerformer(info.performer_name);
-    newPlaylist.setChanged(Changed::isChanged);
-
-    auto playlistUID = newPlaylist.getUniqueID();
-    m_playlistContainer.addPlaylist(std::move(newPlaylist));
-
-    return std::optional<boost::uuids::uuid>(playlistUID);
+std::optional<std::pair<ChangeLog::ChangeSet, ChangeLog::ChangeSet>> SimpleDatabase::changesSince(uint64_t generation) const {
+    auto audioChanges = m_id3Repository->changeLog().since(generation);
+    auto playlistChanges = m_playlistContainer->changeLog().since(generation);
+    if (!audioChanges || !playlistChanges)
+        return std::nullopt;
+    return std::make_pair(ChangeLog::toChangeSet(*audioChanges), ChangeLog::toChangeSet(*playlistChanges));
+}
 
+std::size_t SimpleDatabase::collectGarbage() {
+    std::size_t removed {0};
+    // only a change copies the repository
+    if (m_id3Repository->orphanCoverCount() > 0)
+        removed = m_id3Repository.write().collectCoverGarbage();
+    else
+        m_id3Repository->removeOrphanCoverFiles();
+    return removed;
 }
 
-std::optional<std::string> SimpleDatabase::passwordFind(const std::string &name) {
+std::optional<std::string> SimpleDatabase::passwordFind(const std::string &name) const {
     logger(Level::debug) << "SimpleDatabase::passwordFind\n";
     return m_credentials.passwordFind(name); }
 
@@ -130,99 +170,97 @@ bool SimpleDatabase::addToPlaylistName(const std::string &playlistName, std::str
         return false;
     }
 
-    return m_playlistContainer.addItemToPlaylistName(playlistName, std::move(uid));
+    return m_playlistContainer.write().addItemToPlaylistName(playlistName, std::move(uid));
 }
 
 bool SimpleDatabase::addToPlaylistUID(const boost::uuids::uuid &playlistUid, boost::uuids::uuid &&uid) {
 
-    return m_playlistContainer.addItemToPlaylistUID(playlistUid, std::move(uid));
+    return m_playlistContainer.write().addItemToPlaylistUID(playlistUid, std::move(uid));
 }
 
 bool SimpleDatabase::writeChangedPlaylists() {
-    return m_playlistContainer.writeChangedPlaylists();
+    return m_playlistContainer.write().writeChangedPlaylists();
 }
 
-std::optional<boost::uuids::uuid> SimpleDatabase::convertPlaylist(const std::string &name) {
-    return m_playlistContainer.convertName(name);
+std::optional<boost::uuids::uuid> SimpleDatabase::convertPlaylist(const std::string &name) const {
+    return m_playlistContainer->convertName(name);
 }
 
-std::optional<std::string> SimpleDatabase::convertPlaylist(const boost::uuids::uuid &name) {
-    return m_playlistContainer.convertName(name);
+std::optional<std::string> SimpleDatabase::convertPlaylist(const boost::uuids::uuid &name) const {
+    return m_playlistContainer->convertName(name);
 }
 
-std::optional<Playlist> SimpleDatabase::getPlaylistByName(const std::string &playlistName) {
-    auto list = m_playlistContainer.getPlaylistByName(playlistName);
-    return list->get();
+std::optional<Playlist> SimpleDatabase::getPlaylistByName(const std::string &playlistName) const {
+    if (auto playlist = m_playlistContainer->getPlaylistByName(playlistName))
+        return *playlist;
+    return std::nullopt;
 }
 
-std::optional<std::vector<boost::uuids::uuid> > SimpleDatabase::getPlaylistByUID(const boost::uuids::uuid &playlistName) {
-    auto playlist = m_playlistContainer.getPlaylistByUID(playlistName);
-    if (playlist) {
-        return playlist->get().getPlaylist();
+std::optional<std::vector<boost::uuids::uuid> > SimpleDatabase::getPlaylistByUID(const boost::uuids::uuid &playlistName) const {
+    auto playlistList = m_playlistContainer->findPlaylists(playlistName);
+    if (!playlistList.empty()) {
+        return playlistList[0].getUniqueAudioIdsPlaylist();
     }
     return std::nullopt;
 }
 
 bool SimpleDatabase::setCurrentPlaylistUniqueId(boost::uuids::uuid uniqueID) {
-    return m_playlistContainer.setCurrentPlaylist(std::move(uniqueID));
+    return m_playlistContainer.write().setCurrentPlaylist(std::move(uniqueID));
 }
 
 
-std::optional<const boost::uuids::uuid> SimpleDatabase::getCurrentPlaylistUniqueID() {
-    return m_playlistContainer.getCurrentPlaylistUniqueID();
+std::optional<const boost::uuids::uuid> SimpleDatabase::getCurrentPlaylistUniqueID() const {
+    return m_playlistContainer->getCurrentPlaylistUniqueID();
 }
 
-std::vector<std::pair<std::string, boost::uuids::uuid> > SimpleDatabase::getAllPlaylists() {
+std::vector<std::pair<std::string, boost::uuids::uuid> > SimpleDatabase::getAllPlaylists() const {
     std::vector<std::pair<std::string, boost::uuids::uuid>> list;
 
-    return m_playlistContainer.getAllPlaylists();
+    return m_playlistContainer->getAllPlaylists();
 }
 
 bool SimpleDatabase::addNewAudioFileUniqueId(const Common::FileNameType &uniqueID) {
 
-    if (auto entryUID = m_id3Repository.add(uniqueID)) {
+    if (auto entryUID = m_id3Repository.write().add(uniqueID)) {
         // find playlist or create one
         if (entryUID) {
             // if there is no album playlist, create one
             // add the new entry
             addSingleSongToAlbumPlaylist(*entryUID);
-            m_id3Repository.writeCache();
+            // only the new item is evaluated against the rules of the smart playlists
+            if (auto info = m_id3Repository->findByUid(*entryUID))
+                m_playlistContainer.write().addItemToSmartPlaylists(*info);
+            m_id3Repository.write().writeCache();
         }
     }
     return true;
 
 }
 
-std::vector<Id3Info> SimpleDatabase::getIdListOfItemsInPlaylistId(const boost::uuids::uuid &uniqueId) {
-    std::vector<Id3Info> itemList;
-    if (auto playlistNameOpt = m_playlistContainer.getPlaylistByUID(uniqueId)) {
-        logger(Level::info) << "playlist found for <"<<uniqueId<<"> (name:" << playlistNameOpt->get().getName()<<" | num:" << playlistNameOpt->get().getPlaylist().size() << ")\n";
-        for (auto playlistItemUID : playlistNameOpt->get().getPlaylist()) {
-            auto id3 = m_id3Repository.search(playlistItemUID, SearchItem::uid, SearchAction::uniqueId);
-            if (id3.size() == 1) {
-                itemList.push_back(id3.front());
-            }
-        }
+ResultList<Id3Info> SimpleDatabase::getIdListOfItemsInPlaylistId(const boost::uuids::uuid &uniqueId) const {
+    auto playlistList = m_playlistContainer->findPlaylists(uniqueId);
+    if (!playlistList.empty()) {
+        const auto& playlist = playlistList[0].getUniqueAudioIdsPlaylist();
+        logger(Level::info) << "playlist found for <"<<uniqueId<<"> (name:" << playlistList[0].getName()<<" | num:" << playlist.size() << ")\n";
+        return m_id3Repository->findByUidList(playlist);
     }
-    return itemList;
+    return ResultList<Id3Info>();
 }
 
-Common::AlbumPlaylistAndNames SimpleDatabase::getAlbumPlaylistAndNames() {
+Common::AlbumPlaylistAndNames SimpleDatabase::getAlbumPlaylistAndNames() const {
 
     Common::AlbumPlaylistAndNames albumPlaylistAndNames;
 
-    if (auto playlistNameOpt = m_playlistContainer.getCurrentPlaylist()) {
+    if (auto playlistNameOpt = m_playlistContainer->getCurrentPlaylist()) {
         albumPlaylistAndNames.m_playlistUniqueId = playlistNameOpt->getUniqueID();
         albumPlaylistAndNames.m_playlistName = playlistNameOpt->getName();
-        const std::vector<boost::uuids::uuid> uniqueIdPlaylist = playlistNameOpt->getUniqueAudioIdsPlaylist();
-        for (auto& uniqueId : uniqueIdPlaylist) {
-            auto item = m_id3Repository.getId3InfoByUid(uniqueId);
-            if (item) {
-                Common::PlaylistItem playlistItem;
-                playlistItem.m_url = item->urlAudioFile;
-                playlistItem.m_uniqueId = uniqueId;
-                albumPlaylistAndNames.m_playlist.emplace_back(playlistItem);
-            }
+        auto itemList = m_id3Repository->findByUidList(playlistNameOpt->getUniqueAudioIdsPlaylist());
+        albumPlaylistAndNames.m_playlist.reserve(itemList.size());
+        for (const auto& item : itemList) {
+            Common::PlaylistItem playlistItem;
+            playlistItem.m_url = item.urlAudioFile;
+            playlistItem.m_uniqueId = item.uid;
+            albumPlaylistAndNames.m_playlist.emplace_back(std::move(playlistItem));
         }
 
         logger(Level::debug) << "Album playlist found for <" << albumPlaylistAndNames.m_playlistUniqueId
@@ -238,16 +276,25 @@ Common::AlbumPlaylistAndNames SimpleDatabase::getAlbumPlaylistAndNames() {
 }
 
 std::optional<std::vector<boost::uuids::uuid> > SimpleDatabase::getSongInPlaylistByName
-(const std::string &_songName, const boost::uuids::uuid &albumUuid) {
+(const std::string &_songName, const boost::uuids::uuid &albumUuid) const {
 
     std::vector<boost::uuids::uuid> songList;
 
-    auto infoList = getIdListOfItemsInPlaylistId(albumUuid);
-    std::string songName = Common::str_tolower(_songName);
+    auto playlist = m_playlistContainer->findPlaylists(albumUuid);
+    if (playlist.size() != 1)
+        return std::nullopt;
 
-    for (const auto& infoElem : infoList) {
-        if (infoElem.getNormalizedTitle() == songName) {
+    // the uid of an album playlist is derived from its name, its titles are found by the (album, title) index
+    if (Common::albumPlaylistUid(playlist[0].getNameLower()) == albumUuid) {
+        for (const auto& infoElem : m_id3Repository->findByAlbumTitle(albumUuid, _songName))
             songList.push_back(infoElem.uid);
+    }
+    else {
+        std::string songName = Common::normalize(_songName);
+        for (const auto& infoElem : m_id3Repository->findByUidList(playlist[0].getUniqueAudioIdsPlaylist())) {
+            if (infoElem.getNormalizedTitle() == songName) {
+                songList.push_back(infoElem.uid);
+            }
         }
     }
 
@@ -257,20 +304,30 @@ std::optional<std::vector<boost::uuids::uuid> > SimpleDatabase::getSongInPlaylis
     return songList;
 }
 
-std::optional<std::vector<char> > SimpleDatabase::getCover(const boost::uuids::uuid &uid) {
+std::optional<boost::uuids::uuid> SimpleDatabase::findAlbumPlaylist(const std::string &albumName) const {
 
-    auto& coverElement = m_id3Repository.getCover(uid);
-    if (coverElement.rawData.size()>0) {
+    auto albumUid = Common::albumPlaylistUid(Common::normalize(albumName));
+    if (!m_playlistContainer->findPlaylists(albumUid).empty())
+        return albumUid;
+
+    // any other playlist with exactly this name
+    return m_playlistContainer->convertName(albumName);
+}
+
+std::optional<std::vector<char> > SimpleDatabase::getCover(const boost::uuids::uuid &uid) const {
+
+    auto& coverElement = m_id3Repository->getCover(uid);
+    if (coverElement.hasImage()) {
         logger(LoggerFramework::Level::debug) << "found cover for cover id <" << boost::uuids::to_string(uid) << "> in database\n";
-        return coverElement.rawData;
+        return *coverElement.rawData;
     }
     else
         logger(LoggerFramework::Level::debug) << "NO cover in database found for cover id <" << uid << ">\n";
     return std::nullopt;
 }
 
-std::optional<std::string> SimpleDatabase::getFileFromUUID(boost::uuids::uuid &uuid) {
-    auto id3Info = m_id3Repository.search(uuid, SearchItem::uid, SearchAction::uniqueId);
+std::optional<std::string> SimpleDatabase::getFileFromUUID(boost::uuids::uuid &uuid) const {
+    auto id3Info = m_id3Repository->find(uuid, SearchItem::uid, SearchAction::uniqueId);
     if (id3Info.size() == 1) {
         // test if this is a local file
         logger(Level::warning) << "requested uuid <" << uuid << "> found url: "<<id3Info[0].informationSource <<"\n";
@@ -290,28 +347,33 @@ std::optional<std::string> SimpleDatabase::getFileFromUUID(boost::uuids::uuid &u
     return std::nullopt;
 }
 
-std::optional<std::string> SimpleDatabase::getM3UPlaylistFromUUID(boost::uuids::uuid &uuid) {
-    return m_playlistContainer.createvirtual_m3u(uuid);
+std::optional<std::string> SimpleDatabase::getM3UPlaylistFromUUID(boost::uuids::uuid &uuid) const {
+    return m_playlistContainer->createvirtual_m3u(uuid);
 }
 
 void SimpleDatabase::addSingleSongToAlbumPlaylist(const boost::uuids::uuid &songId) {
-    if (auto info = m_id3Repository.getId3InfoByUid(songId)) {
+    if (auto info = m_id3Repository->findByUid(songId)) {
         logger(Level::info) << "found file <"<<info->title_name << "/"<<info->album_name<<"> to add\n";
-        if (auto pl_uid = getTemporalPlaylistByName(*info)) {
-            if (auto pl_ref = m_playlistContainer.getPlaylistByUID(*pl_uid)) {
-                auto& pl = pl_ref->get();
-                logger(Level::info) << "playlist (" << pl.getUniqueID()
-                                    << ") to add found/created: " << pl.getName()
-                                    << "/" << pl.getPerformer() << "\n";
-                auto uuid = info->uid;
-                pl.setCover(info->urlCoverFile);
-                pl.addToList(std::move(uuid));
-            }
-
-        } else {
-            logger(Level::warning) << "no playlist with the album name found or cannot be generated\n";
-        }
+        if (!m_playlistContainer.write().addToAlbumPlaylist(*info, *m_id3Repository))
+            logger(Level::debug) << "no album playlist for <" << info->album_name << ">\n";
     } else {
         logger(Level::warning) << "no song with the given ID\n";
     }
 }
+
+bool SimpleDatabase::removeAudioItem(const boost::uuids::uuid &songId) {
+    if (auto info = m_id3Repository->findByUid(songId)) {
+        // no playlist may refer to the removed item
+        auto& playlistContainer = m_playlistContainer.write();
+        playlistContainer.removeFromAlbumPlaylist(*info);
+        if (playlistContainer.removeItemFromPlaylists(songId) > 0)
+            playlistContainer.writeChangedPlaylists();
+        // the cover of the item is released and collected later
+        if (m_id3Repository.write().remove(songId)) {
+            m_id3Repository.write().writeCache();
+            return true;
+        }
+    }
+    logger(Level::warning) << "no song with the given ID <" << songId << "> to remove\n";
+    return false;
+}
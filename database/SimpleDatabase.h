@@ -19,30 +19,65 @@
 #include "id3repository.h"
 #include "common/generalPlaylist.h"
 #include "credential.h"
+#include "snapshot.h"
 
 namespace Database {
 
 class SimpleDatabase {
 
-    PlaylistContainer m_playlistContainer;
-    Id3Repository m_id3Repository;
+    // shared with the other versions of the database until changed
+    CopyOnWrite<PlaylistContainer> m_playlistContainer;
+    CopyOnWrite<Id3Repository> m_id3Repository;
     Credential m_credentials;
 
 public:
 
-    SimpleDatabase(bool enableCache) :m_id3Repository(enableCache) {}
+    SimpleDatabase(bool enableCache) :m_id3Repository(std::make_shared<Id3Repository>(enableCache)) {
+        m_playlistContainer.write().shareGenerationSequence(m_id3Repository->changeLog());
+    }
 
     void loadDatabase();
+
+    // build all lazily created search data, so that a published version is never changed by a reader
+    void seal() const;
+
+    // changes with every modification of audio items, playlists or the current playlist
+    // (both take their generations from one sequence)
+    uint64_t generation() const { return std::max(m_id3Repository->generation(), m_playlistContainer->generation()); }
+
+    // audio items and playlists changed after the generation, nullopt if these changes are not logged anymore
+    std::optional<std::pair<ChangeLog::ChangeSet, ChangeLog::ChangeSet>> changesSince(uint64_t generation) const;
     bool writeChangedPlaylists();
 
-    std::vector<Id3Info> searchAudioItems(const std::string &what, SearchItem item, SearchAction action);
-    std::vector<Id3Info> searchAudioItems(const boost::uuids::uuid &what, SearchItem item, SearchAction action);
-    std::vector<Id3Info> searchAudioItems(std::string_view what, SearchItem item, SearchAction action);
-    std::vector<Id3Info> searchAudioItems(const char* what, SearchItem item, SearchAction action);
+    std::vector<Id3Info> searchAudioItems(const std::string &what, SearchItem item, SearchAction action) const;
+    std::vector<Id3Info> searchAudioItems(const boost::uuids::uuid &what, SearchItem item, SearchAction action) const;
+    std::vector<Id3Info> searchAudioItems(std::string_view what, SearchItem item, SearchAction action) const;
+    std::vector<Id3Info> searchAudioItems(const char* what, SearchItem item, SearchAction action) const;
+    std::vector<Id3Info> searchAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const;
+
+    // handles into the database, valid until the next modification
+    ResultList<Id3Info> findAudioItems(const std::string &what, SearchItem item, SearchAction action) const;
+    ResultList<Id3Info> findAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const;
+    ResultList<Playlist> findPlaylistItems(const std::string &what, SearchAction action = SearchAction::exact) const;
+    ResultList<Id3Info> findAudioItems(const std::vector<boost::uuids::uuid>& uidList) const { return m_id3Repository->findByUidList(uidList); }
+    ResultList<Playlist> findPlaylistItems(const std::vector<boost::uuids::uuid>& uidList) const { return m_playlistContainer->findByUidList(uidList); }
+
+    // one page of the result in the requested order, the next cursor is given with the result list
+    ResultList<Id3Info> findAudioItems(const std::string &what, SearchItem item, SearchAction action, const PageRequest& page) const;
+    ResultList<Id3Info> findAudioItems(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action, const PageRequest& page) const;
+    ResultList<Playlist> findPlaylistItems(const std::string &what, SearchAction action, const PageRequest& page) const;
 
-    std::vector<Playlist> searchPlaylistItems(const std::string &what, SearchAction action = SearchAction::exact);
-    std::vector<Playlist> searchPlaylistItems(const std::string_view &what, SearchAction action = SearchAction::exact);
-    std::vector<Playlist> searchPlaylistItems(const boost::uuids::uuid &what, SearchAction action = SearchAction::exact);
+    // search-as-you-type: words starting with prefix, the state refines the request of the last keystroke
+    std::vector<std::string> completeWords(const std::string& prefix, CompletionIndex::State& state) const;
+
+    std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> findDuplicates(DuplicateKey key) const;
+
+    // number of audio items per performer, album and tag
+    const LibraryFacets& facets() const { return m_id3Repository->facets(); }
+
+    std::vector<Playlist> searchPlaylistItems(const std::string &what, SearchAction action = SearchAction::exact) const;
+    std::vector<Playlist> searchPlaylistItems(const std::string_view &what, SearchAction action = SearchAction::exact) const;
+    std::vector<Playlist> searchPlaylistItems(const boost::uuids::uuid &what, SearchAction action = SearchAction::exact) const;
 
     std::optional<boost::uuids::uuid> createPlaylist(const std::string &name, Database::Persistent persistent);
 
@@ -50,38 +85,42 @@ public:
     bool addToPlaylistName(const std::string &playlistName, std::string &&uniqueID);
     bool addNewAudioFileUniqueId(const Common::FileNameType &uniqueID);
 
-    std::optional<Playlist> getPlaylistByName(const std::string& playlistName);
-    std::optional<std::vector<boost::uuids::uuid>> getPlaylistByUID(const boost::uuids::uuid& playlistUniqueId);
+    std::optional<Playlist> getPlaylistByName(const std::string& playlistName) const;
+    std::optional<std::vector<boost::uuids::uuid>> getPlaylistByUID(const boost::uuids::uuid& playlistUniqueId) const;
 
     bool setCurrentPlaylistUniqueId(boost::uuids::uuid uniqueID);
 
-    std::optional<const boost::uuids::uuid> getCurrentPlaylistUniqueID();
+    std::optional<const boost::uuids::uuid> getCurrentPlaylistUniqueID() const;
 
-    std::vector<std::pair<std::string, boost::uuids::uuid>> getAllPlaylists();
+    std::vector<std::pair<std::string, boost::uuids::uuid>> getAllPlaylists() const;
 
-    std::optional<boost::uuids::uuid> convertPlaylist(const std::string& name);
-    std::optional<std::string> convertPlaylist(const boost::uuids::uuid& name);
+    std::optional<boost::uuids::uuid> convertPlaylist(const std::string& name) const;
+    std::optional<std::string> convertPlaylist(const boost::uuids::uuid& name) const;
 
-    std::vector<Id3Info> getIdListOfItemsInPlaylistId(const boost::uuids::uuid& uniqueId);
-    Common::AlbumPlaylistAndNames getAlbumPlaylistAndNames();
+    ResultList<Id3Info> getIdListOfItemsInPlaylistId(const boost::uuids::uuid& uniqueId) const;
+    Common::AlbumPlaylistAndNames getAlbumPlaylistAndNames() const;
 
-    std::optional<std::vector<boost::uuids::uuid>> getSongInPlaylistByName(const std::string& _songName, const boost::uuids::uuid& albumUuid);
+    std::optional<std::vector<boost::uuids::uuid>> getSongInPlaylistByName(const std::string& _songName, const boost::uuids::uuid& albumUuid) const;
+    // album playlist of this album name (compared normalized), or the playlist with exactly this name
+    std::optional<boost::uuids::uuid> findAlbumPlaylist(const std::string& albumName) const;
 
-    std::optional<std::vector<char>> getCover(const boost::uuids::uuid& uid);
+    std::optional<std::vector<char>> getCover(const boost::uuids::uuid& uid) const;
 
-    std::optional<std::string> getFileFromUUID(boost::uuids::uuid& uuid);
+    std::optional<std::string> getFileFromUUID(boost::uuids::uuid& uuid) const;
 
-    std::optional<std::string> getM3UPlaylistFromUUID(boost::uuids::uuid& uuid);
+    std::optional<std::string> getM3UPlaylistFromUUID(boost::uuids::uuid& uuid) const;
 
     void addSingleSongToAlbumPlaylist(const boost::uuids::uuid& songId);
-
-    std::optional<boost::uuids::uuid> getTemporalPlaylistByName(const Id3Info &name);
+    // removes the item from the repository and all playlists
+    bool removeAudioItem(const boost::uuids::uuid& songId);
+    // removes the covers no item refers to anymore (from memory and cache), returns the number of removed covers
+    std::size_t collectGarbage();
 
 #ifdef WITH_UNITTEST
-    bool testInsert(Id3Info&& info) { return m_id3Repository.add(std::move(info)); }
+    bool testInsert(Id3Info&& info) { return m_id3Repository.write().add(std::move(info)); }
 #endif
 
-    std::optional<std::string> passwordFind(const std::string& name);
+    std::optional<std::string> passwordFind(const std::string& name) const;
 
 };
 
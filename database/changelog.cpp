@@ -0,0 +1,66 @@
+#include "changelog.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <boost/functional/hash.hpp>
+
+using namespace Database;
+
+uint64_t ChangeLog::record(Kind kind, const boost::uuids::uuid &uid) {
+
+    auto generation = next();
+
+    if (m_capacity == 0) {
+        m_lostUntil = generation;
+        return generation;
+    }
+
+    if (m_changeList.size() == m_capacity) {
+        m_lostUntil = m_changeList.front().generation;
+        m_changeList.pop_front();
+    }
+    m_changeList.push_back({ generation, kind, uid });
+
+    return generation;
+}
+
+std::optional<std::vector<ChangeLog::Change>> ChangeLog::since(uint64_t generation) const {
+
+    if (generation < m_lostUntil)
+        return std::nullopt;
+
+    auto begin = std::upper_bound(std::begin(m_changeList), std::end(m_changeList), generation,
+                                  [](uint64_t value, const Change& change) { return value < change.generation; });
+
+    return std::vector<Change>(begin, std::end(m_changeList));
+}
+
+ChangeLog::ChangeSet ChangeLog::toChangeSet(const std::vector<Change> &changeList) {
+
+    // first and last change of every record
+    std::unordered_map<boost::uuids::uuid, std::pair<const Change*, const Change*>, boost::hash<boost::uuids::uuid>> recordMap;
+    for (const auto& change : changeList) {
+        auto [it, inserted] = recordMap.try_emplace(change.uid, &change, &change);
+        if (!inserted)
+            it->second.second = &change;
+    }
+
+    std::vector<std::pair<const Change*, const Change*>> recordList;
+    recordList.reserve(recordMap.size());
+    for (const auto& [uid, firstAndLast] : recordMap)
+        recordList.push_back(firstAndLast);
+    std::sort(std::begin(recordList), std::end(recordList),
+              [](const auto& record1, const auto& record2) { return record1.second->generation < record2.second->generation; });
+
+    ChangeSet changeSet;
+    for (const auto& [first, last] : recordList) {
+        if (last->kind == Kind::removed)
+            changeSet.removed.push_back(last->uid);
+        else if (first->kind == Kind::added)
+            changeSet.added.push_back(last->uid);
+        else
+            changeSet.modified.push_back(last->uid);
+    }
+
+    return changeSet;
+}
@@ -0,0 +1,81 @@
+#ifndef DATABASE_CHANGELOG_H
+#define DATABASE_CHANGELOG_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <boost/uuid/uuid.hpp>
+
+namespace Database {
+
+/*!
+ * \brief ChangeLog keeps the latest changes (added, removed or modified records) of
+ * a repository, each stamped with the generation it created. A client that knows
+ * the generation of its copy asks for the changes since then, instead of reloading
+ * everything.
+ * The generations are taken from a sequence shared by all logs of one database, so
+ * the changes of audio items and playlists are ordered by one generation number.
+ * Only the last capacity changes are kept, older ones are lost and a client behind
+ * them has to reload (resync).
+ */
+class ChangeLog {
+
+public:
+    enum class Kind {
+        added,
+        removed,
+        modified
+    };
+
+    struct Change {
+        uint64_t generation {0};
+        Kind kind { Kind::modified };
+        boost::uuids::uuid uid;
+    };
+
+    // the resulting change of every record, in the order of their last change
+    struct ChangeSet {
+        std::vector<boost::uuids::uuid> added;
+        std::vector<boost::uuids::uuid> modified;
+        std::vector<boost::uuids::uuid> removed;
+    };
+
+    static constexpr std::size_t defaultCapacity { 1024 };
+
+private:
+    std::shared_ptr<uint64_t> m_sequence;
+    std::deque<Change> m_changeList;
+    std::size_t m_capacity;
+    uint64_t m_lostUntil {0}; //< changes up to this generation are not in the log anymore
+
+public:
+    explicit ChangeLog(std::size_t capacity = defaultCapacity)
+        : m_sequence(std::make_shared<uint64_t>(0)), m_capacity(capacity) {}
+
+    // take the generations from the sequence of the other log from now on
+    void shareSequence(const ChangeLog& other) { m_sequence = other.m_sequence; }
+
+    // a new generation for a change that is not logged (e.g. the current playlist)
+    uint64_t next() { return ++*m_sequence; }
+
+    // a new generation for a change of the record with this uid
+    uint64_t record(Kind kind, const boost::uuids::uuid& uid);
+
+    // forget all changes so far (e.g. after the repository was cleared), every client has to reload
+    uint64_t truncate() { m_changeList.clear(); m_lostUntil = next(); return m_lostUntil; }
+
+    // all changes after the generation in order, nullopt if some of them are lost
+    std::optional<std::vector<Change>> since(uint64_t generation) const;
+
+    // several changes of one record are merged (e.g. added and modified is added)
+    static ChangeSet toChangeSet(const std::vector<Change>& changeList);
+
+    std::size_t size() const { return m_changeList.size(); }
+
+};
+
+}
+
+#endif // DATABASE_CHANGELOG_H
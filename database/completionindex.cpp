@@ -0,0 +1,110 @@
+#include "completionindex.h"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace Database;
+
+namespace {
+
+// multibyte utf-8 sequences are kept as part of the word
+inline bool isWordCharacter(char character) {
+    auto value = static_cast<unsigned char>(character);
+    return value >= 0x80 || std::isalnum(value);
+}
+
+}
+
+void CompletionIndex::addText(std::string_view text) {
+
+    std::size_t position {0};
+    while (position < text.length()) {
+        while (position < text.length() && !isWordCharacter(text[position]))
+            ++position;
+        auto begin = position;
+        while (position < text.length() && isWordCharacter(text[position]))
+            ++position;
+        if (position > begin)
+            ++m_wordCount[std::string(text.substr(begin, position - begin))];
+    }
+}
+
+void CompletionIndex::clear() {
+    m_entries.clear();
+    m_wordCount.clear();
+}
+
+void CompletionIndex::seal() {
+
+    m_entries.reserve(m_entries.size() + m_wordCount.size());
+    for (auto& [word, count] : m_wordCount)
+        m_entries.push_back({ word, count });
+    m_wordCount.clear();
+
+    std::sort(std::begin(m_entries), std::end(m_entries),
+              [](const Entry& entry1, const Entry& entry2) { return entry1.word < entry2.word; });
+
+    // words added in several runs are merged
+    auto out = std::begin(m_entries);
+    for (auto it = std::begin(m_entries); it != std::end(m_entries); ++it) {
+        if (out != std::begin(m_entries) && std::prev(out)->word == it->word)
+            std::prev(out)->count += it->count;
+        else if (out++ != it)
+            *std::prev(out) = std::move(*it);
+    }
+    m_entries.erase(out, std::end(m_entries));
+
+    ++m_generation;
+}
+
+CompletionIndex::Range CompletionIndex::findPrefix(std::string_view prefix, Range within) const {
+
+    auto first = std::begin(m_entries) + static_cast<std::ptrdiff_t>(within.begin);
+    auto last = std::begin(m_entries) + static_cast<std::ptrdiff_t>(within.end);
+
+    auto begin = std::lower_bound(first, last, prefix,
+                                  [](const Entry& entry, std::string_view value) { return entry.word < value; });
+    // the words starting with the prefix directly follow the lower bound
+    auto end = std::partition_point(begin, last,
+                                    [&prefix](const Entry& entry) { return entry.word.compare(0, prefix.length(), prefix) == 0; });
+
+    return { static_cast<std::size_t>(begin - std::begin(m_entries)),
+             static_cast<std::size_t>(end - std::begin(m_entries)) };
+}
+
+std::vector<std::string> CompletionIndex::top(Range range, std::size_t limit) const {
+
+    std::vector<const Entry*> candidateList;
+    auto end = std::min(range.end, range.begin + maxScan);
+    candidateList.reserve(end - range.begin);
+    for (auto position = range.begin; position < end; ++position)
+        candidateList.push_back(&m_entries[position]);
+
+    limit = std::min(limit, candidateList.size());
+    // most frequent first, alphabetical on equal count
+    std::partial_sort(std::begin(candidateList), std::begin(candidateList) + static_cast<std::ptrdiff_t>(limit), std::end(candidateList),
+                      [](const Entry* entry1, const Entry* entry2) {
+        return entry1->count > entry2->count || (entry1->count == entry2->count && entry1->word < entry2->word);
+    });
+
+    std::vector<std::string> wordList;
+    wordList.reserve(limit);
+    for (std::size_t i{0}; i < limit; ++i)
+        wordList.push_back(candidateList[i]->word);
+
+    return wordList;
+}
+
+std::vector<std::string> CompletionIndex::complete(std::string_view prefix, State& state, std::size_t limit) const {
+
+    // a longer prefix only narrows the previous range, anything else starts over
+    bool refine = state.generation == m_generation &&
+            prefix.length() >= state.prefix.length() &&
+            prefix.substr(0, state.prefix.length()) == state.prefix;
+
+    state.range = findPrefix(prefix, refine ? state.range : all());
+    state.prefix = std::string(prefix);
+    state.generation = m_generation;
+
+    return top(state.range, limit);
+}
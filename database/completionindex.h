@@ -0,0 +1,76 @@
+#ifndef DATABASE_COMPLETIONINDEX_H
+#define DATABASE_COMPLETIONINDEX_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Database {
+
+/*!
+ * \brief CompletionIndex is a sorted array of all distinct (normalized) words of the
+ * repository together with their number of occurrences.
+ * All words starting with a prefix form a contiguous range of this array, found by
+ * binary search. A longer prefix can only narrow that range, so a search-as-you-type
+ * request is refined within the range of the previous keystroke.
+ */
+class CompletionIndex {
+
+public:
+    struct Entry {
+        std::string word;
+        uint32_t count {0};
+    };
+
+    // range [begin, end) within the sorted word array
+    struct Range {
+        std::size_t begin {0};
+        std::size_t end {0};
+
+        std::size_t size() const { return end - begin; }
+    };
+
+    // the last completion request of a session, used to refine the next one
+    struct State {
+        std::string prefix;
+        Range range;
+        uint32_t generation {0};
+    };
+
+    static constexpr std::size_t defaultLimit { 10 };
+    // words looked at for the ranking, keeps short prefixes on big libraries responsive
+    static constexpr std::size_t maxScan { 4096 };
+
+private:
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, uint32_t> m_wordCount;
+    uint32_t m_generation {0};
+
+public:
+
+    // split the text into words and collect them, must be followed by seal()
+    void addText(std::string_view text);
+    void clear();
+    // sort the collected words, a new generation invalidates all ranges given out before
+    void seal();
+
+    uint32_t generation() const { return m_generation; }
+    std::size_t size() const { return m_entries.size(); }
+    Range all() const { return { 0, m_entries.size() }; }
+
+    // all words starting with prefix, searched within the given range only
+    Range findPrefix(std::string_view prefix, Range within) const;
+
+    // the most frequent words of the range (at most limit, scanning at most maxScan words)
+    std::vector<std::string> top(Range range, std::size_t limit = defaultLimit) const;
+
+    // complete the prefix, refining the session state when the prefix extends the previous one
+    std::vector<std::string> complete(std::string_view prefix, State& state, std::size_t limit = defaultLimit) const;
+
+};
+
+}
+
+#endif // DATABASE_COMPLETIONINDEX_H
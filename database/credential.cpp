@@ -1,8 +1,8 @@
 #include "credential.h"
 
-std::optional<std::string> Database::Credential::passwordFind(const std::string &name) {
+std::optional<std::string> Database::Credential::passwordFind(const std::string &name) const {
 
-    std::vector<std::tuple<std::string, std::string>>::iterator pw =  std::find_if(
+    std::vector<std::tuple<std::string, std::string>>::const_iterator pw =  std::find_if(
                 begin(credentialList),
                 end(credentialList),
                 [&name](const std::tuple<std::string, std::string>& item) {
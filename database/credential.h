@@ -24,7 +24,7 @@ class Credential {
 public:
     Credential() = default;
 
-    std::optional<std::string> passwordFind(const std::string& name);
+    std::optional<std::string> passwordFind(const std::string& name) const;
 
     bool read();
 
@@ -9,9 +9,12 @@
 #include "common/Constants.h"
 #include "common/filesystemadditions.h"
 #include "common/albumlist.h"
+#include "common/arena.h"
 #include <iterator>
+#include <fstream>
+#include <map>
+#include <unordered_map>
 #include <vector>
-#include <stack>
 
 using namespace Database;
 using namespace LoggerFramework;
@@ -65,7 +68,7 @@ std::optional<nlohmann::json> Database::coverToJson(const std::vector<CoverEleme
         for (const auto& elem : coverDb) {
             nlohmann::json jsonElem;
             jsonElem[ServerConstant::JsonField::hash] = elem.hash;
-            jsonElem[ServerConstant::JsonField::hasCover] = !elem.rawData.empty();
+            jsonElem[ServerConstant::JsonField::hasCover] = elem.hasImage();
             auto& uidList = jsonElem[ServerConstant::JsonField::uidList];
             for(const auto& uidElem : elem.uidListForCover)
                 uidList.push_back(boost::uuids::to_string(uidElem));
@@ -268,43 +271,75 @@ std::optional<nlohmann::json> Id3Repository::id3ToJson(const std::vector<Id3Info
 
 }
 
-const std::vector<Id3Info> Id3Repository::id3fromJson(const std::string &file) const {
+namespace {
+
+// json document with all nodes and strings taken from the current arena
+using ArenaString = std::basic_string<char, std::char_traits<char>, Common::ArenaAllocator<char>>;
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t, double, Common::ArenaAllocator>;
+
+template <typename Json>
+const Json& field(const Json& object, const std::string& name) {
+    return object.at(typename Json::string_t(name.data(), name.length()));
+}
+
+template <typename Json>
+std::string_view text(const Json& value) {
+    const auto& string = value.template get_ref<const typename Json::string_t&>();
+    return std::string_view(string.data(), string.length());
+}
+
+template <typename Json>
+std::vector<Id3Info> readId3Json(std::istream& stream) {
 
     std::vector<Id3Info> id3Data;
+    Json streamList = Json::parse(stream);
+    id3Data.reserve(streamList.size());
+
+    for (const auto& streamInfo : streamList) {
+        Id3Info info;
+        info.uid = boost::lexical_cast<boost::uuids::uuid>(std::string(text(field(streamInfo, "Uid"))));
+
+        info.informationSource = text(field(streamInfo, ServerConstant::JsonField::infoSrc));
+        info.title_name = std::string(text(field(streamInfo, ServerConstant::JsonField::title)));
+        info.album_name = text(field(streamInfo, ServerConstant::JsonField::album));
+        info.performer_name = text(field(streamInfo, ServerConstant::JsonField::performer));
+        info.track_no = field(streamInfo, ServerConstant::JsonField::trackNo).template get<uint32_t>();
+        info.all_tracks_no = field(streamInfo, ServerConstant::JsonField::allTrackNo).template get<uint32_t>();
+        info.coverFileExt = text(field(streamInfo, ServerConstant::JsonField::extension));
+        info.albumCreation = field(streamInfo, ServerConstant::JsonField::albumCreation).template get<bool>();
+        info.cd_no = field(streamInfo, ServerConstant::JsonField::disk).template get<uint32_t>();
+        info.urlAudioFile = text(field(streamInfo, ServerConstant::JsonField::url));
+        info.urlCoverFile = text(field(streamInfo, ServerConstant::JsonField::coverUrl));
+
+        info.finishEntry();
+        logger(LoggerFramework::Level::debug) << "reading <" << boost::uuids::to_string(info.uid) << "> <"<<info.title_name<<">\n";
+        id3Data.emplace_back(std::move(info));
+    }
+
+    return id3Data;
+}
+
+}
+
+std::vector<Id3Info> Id3Repository::id3fromJson(const std::string &file, LoadAllocator allocator) {
 
     if (fs::exists(file)) {
-        FullId3Information fullInfo;
         try {
             std::ifstream streamInfoFile(file.c_str());
-            nlohmann::json streamList = nlohmann::json::parse(streamInfoFile);
-
-            for (const auto& streamInfo : streamList) {
-            Id3Info info;
-            info.uid = boost::lexical_cast<boost::uuids::uuid>(std::string(streamInfo.at("Uid")));
-
-            info.informationSource = streamInfo.at(ServerConstant::JsonField::infoSrc);
-            info.title_name = streamInfo.at(ServerConstant::JsonField::title);
-            info.album_name = streamInfo.at(ServerConstant::JsonField::album);
-            info.performer_name = streamInfo.at(ServerConstant::JsonField::performer);
-            info.track_no = streamInfo.at(ServerConstant::JsonField::trackNo);
-            info.all_tracks_no = streamInfo.at(ServerConstant::JsonField::allTrackNo);
-            info.coverFileExt = streamInfo.at(ServerConstant::JsonField::extension);
-            info.albumCreation = streamInfo.at(ServerConstant::JsonField::albumCreation);
-            info.cd_no = streamInfo.at(ServerConstant::JsonField::disk);
-            info.urlAudioFile = streamInfo.at(ServerConstant::JsonField::url);
-            info.urlCoverFile = streamInfo.at(ServerConstant::JsonField::coverUrl);
-
-            info.finishEntry();
-            logger(LoggerFramework::Level::debug) << "reading <" << boost::uuids::to_string(info.uid) << "> <"<<info.title_name<<">\n";
-            id3Data.emplace_back(info);
+            if (allocator == LoadAllocator::arena) {
+                // the document is gone before the arena, only the audio items are kept
+                Common::Arena arena;
+                Common::Arena::Scope scope(arena);
+                return readId3Json<ArenaJson>(streamInfoFile);
             }
+            return readId3Json<nlohmann::json>(streamInfoFile);
 
         } catch (std::exception& ex) {
             logger(Level::warning) << "failed to read file: " << file << ": " << ex.what() << "\n";
             return {};
         }
     }
-    return id3Data;
+    return {};
 
 }
 
@@ -328,6 +363,7 @@ std::optional<boost::uuids::uuid> Id3Repository::add(std::optional<FullId3Inform
         }
 
         m_simpleDatabase.emplace_back(std::move(audioItem->info));
+        indexEntry(m_simpleDatabase.size()-1);
         if (audioItem->pictureAvailable) {
             if (addCover(std::move(uniqueID), std::move(audioItem->data)))
                 logger(Level::debug) << "added audioItem <" << uniqueID << ">\n";
@@ -338,6 +374,115 @@ std::optional<boost::uuids::uuid> Id3Repository::add(std::optional<FullId3Inform
     return std::nullopt;
 }
 
+namespace {
+
+// sections of the index file
+enum IndexSection : uint32_t {
+    uidTable = 1,
+    titleGrams, titleOffsets, titleRows,
+    albumGrams, albumOffsets, albumRows,
+    performerGrams, performerOffsets, performerRows,
+    titleOrder, performerOrder, addedOrder
+};
+
+std::string indexFileName() {
+    return Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache) + "/search_index.bin";
+}
+
+std::string coverCacheFileName() {
+    return Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache) + "/cover_cache.json";
+}
+
+}
+
+uint64_t Id3Repository::contentChecksum() const {
+
+    uint64_t checksum = Common::genHash64(&IndexFile::version, sizeof(IndexFile::version));
+    auto add = [&checksum](const std::string& text) {
+        // the length separates the fields
+        uint64_t length { text.length() };
+        checksum = Common::genHash64(&length, sizeof(length), checksum);
+        checksum = Common::genHash64(text.data(), text.length(), checksum);
+    };
+
+    for (const auto& info : m_simpleDatabase) {
+        checksum = Common::genHash64(info.uid.data, info.uid.size(), checksum);
+        checksum = Common::genHash64(&info.track_no, sizeof(info.track_no), checksum);
+        add(info.getNormalizedTitle());
+        add(info.getNormalizedAlbum());
+        add(info.getNormalizedPerformer());
+    }
+
+    return checksum;
+}
+
+bool Id3Repository::restoreSearchIndexes(const IndexFile::Reader &reader) {
+
+    auto rowCount = m_simpleDatabase.size();
+    auto restoreTrigrams = [&reader, rowCount](TrigramIndex& index, uint32_t grams, uint32_t offsets, uint32_t rows) {
+        auto gramList = reader.section<uint32_t>(grams);
+        auto offsetList = reader.section<uint32_t>(offsets);
+        auto rowList = reader.section<TrigramIndex::RowId>(rows);
+        return gramList && offsetList && rowList && index.assign(*gramList, *offsetList, *rowList, rowCount);
+    };
+
+    auto uidTable = reader.section<UuidIndex::Entry>(IndexSection::uidTable);
+    if (uidTable && m_uidIndex.assignTable(*uidTable, rowCount) && m_uidIndex.size() == rowCount &&
+            restoreTrigrams(m_titleIndex, IndexSection::titleGrams, IndexSection::titleOffsets, IndexSection::titleRows) &&
+            restoreTrigrams(m_albumIndex, IndexSection::albumGrams, IndexSection::albumOffsets, IndexSection::albumRows) &&
+            restoreTrigrams(m_performerIndex, IndexSection::performerGrams, IndexSection::performerOffsets, IndexSection::performerRows))
+        return true;
+
+    logger(Level::warning) << "index file cannot be used, rebuilding search indexes\n";
+    m_uidIndex.clear();
+    m_titleIndex.clear();
+    m_albumIndex.clear();
+    m_performerIndex.clear();
+    return false;
+}
+
+bool Id3Repository::restoreOrders(const IndexFile::Reader &reader) {
+
+    auto titleOrder = reader.section<uint32_t>(IndexSection::titleOrder);
+    auto performerOrder = reader.section<uint32_t>(IndexSection::performerOrder);
+    auto addedOrder = reader.section<uint32_t>(IndexSection::addedOrder);
+    auto isOrder = [this](const auto& order) {
+        return order && order->size == m_simpleDatabase.size() &&
+                std::all_of(std::begin(*order), std::end(*order), [this](uint32_t row) { return row < m_simpleDatabase.size(); });
+    };
+    if (!isOrder(titleOrder) || !isOrder(performerOrder) || !isOrder(addedOrder))
+        return false;
+
+    m_titleOrder.assign(std::begin(*titleOrder), std::end(*titleOrder));
+    m_performerOrder.assign(std::begin(*performerOrder), std::end(*performerOrder));
+    m_addedOrder.assign(std::begin(*addedOrder), std::end(*addedOrder));
+    m_ordersDirty = false;
+    return true;
+}
+
+bool Id3Repository::writeSearchIndexes(const std::string &filename) const {
+
+    IndexFile::Writer writer;
+    writer.add(IndexSection::uidTable, m_uidIndex.table());
+
+    auto addTrigrams = [&writer](const TrigramIndex& index, uint32_t grams, uint32_t offsets, uint32_t rows) {
+        auto flat = index.flatten();
+        writer.add(grams, flat.gramList);
+        writer.add(offsets, flat.offsetList);
+        writer.add(rows, flat.rowList);
+    };
+    addTrigrams(m_titleIndex, IndexSection::titleGrams, IndexSection::titleOffsets, IndexSection::titleRows);
+    addTrigrams(m_albumIndex, IndexSection::albumGrams, IndexSection::albumOffsets, IndexSection::albumRows);
+    addTrigrams(m_performerIndex, IndexSection::performerGrams, IndexSection::performerOffsets, IndexSection::performerRows);
+
+    refreshOrders();
+    writer.add(IndexSection::titleOrder, m_titleOrder);
+    writer.add(IndexSection::performerOrder, m_performerOrder);
+    writer.add(IndexSection::addedOrder, m_addedOrder);
+
+    return writer.write(filename, contentChecksum());
+}
+
 bool Id3Repository::readCache() {
 
     if (! m_enableCache) {
@@ -346,11 +491,9 @@ bool Id3Repository::readCache() {
     }
 
     std::string id3CacheFileBase = "id3_cache";
-    std::string coverCacheFile = Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache)
-            + "/cover_cache.json";
-
 
     // read audio cach information
+    auto firstRow = m_simpleDatabase.size();
     auto cacheFileList = Common::FileSystemAdditions::getAllFilesInDir(FileType::Cache);
     for (auto file : cacheFileList) {
         if ( file.extension == ".json" &&
@@ -359,11 +502,30 @@ bool Id3Repository::readCache() {
             logger(LoggerFramework::Level::debug) << "reading cache file "<< id3CacheFileName <<"\n";
             auto id3DatabaseList = id3fromJson(id3CacheFileName);
             // convert json to id3Info vector
-            m_simpleDatabase.insert(m_simpleDatabase.end(), std::begin(id3DatabaseList), std::end(id3DatabaseList));
+            m_simpleDatabase.reserve(m_simpleDatabase.size() + id3DatabaseList.size());
+            std::move(std::begin(id3DatabaseList), std::end(id3DatabaseList), std::back_inserter(m_simpleDatabase));
         }
     }
 
-    m_simpleCoverDatabase.readCache(coverCacheFile);
+    // the search indexes of an unchanged cache are taken from the index file, otherwise built and written
+    std::optional<IndexFile::Reader> indexFile;
+    if (firstRow == 0)
+        indexFile = IndexFile::Reader::open(indexFileName(), contentChecksum());
+    bool restored = indexFile && restoreSearchIndexes(*indexFile);
+
+    if (!restored)
+        m_uidIndex.reserve(m_simpleDatabase.size());
+    for (auto row = firstRow; row < m_simpleDatabase.size(); ++row)
+        indexEntry(row, !restored);
+
+    if (restored && restoreOrders(*indexFile)) {
+        logger(Level::info) << "search indexes of <" << m_simpleDatabase.size() << "> audio items taken from index file\n";
+    }
+    else if (!restored && firstRow == 0) {
+        writeSearchIndexes(indexFileName());
+    }
+
+    m_simpleCoverDatabase.readCache(coverCacheFileName());
 
     return true;
 }
@@ -383,9 +545,6 @@ bool Id3Repository::writeCacheInternal() {
     logger(Level::debug) << "writing cache\n";
 
     std::string id3CacheFileBase = "id3_cache";
-    std::string coverCacheFile = Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache)
-            + "/cover_cache.json";
-
     // create json files
     auto genCacheName = [](uint32_t id) {
         return Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache)
@@ -421,11 +580,21 @@ bool Id3Repository::writeCacheInternal() {
     }
     std::cerr << "\n";
 
-    m_simpleCoverDatabase.writeCache(coverCacheFile);
+    m_simpleCoverDatabase.writeCache(coverCacheFileName());
 
     return true;
 }
 
+bool Id3Repository::writeCoverCache() {
+
+    if (! m_enableCache) {
+        logger(Level::info) << "cache not enabled, no write on cover cache\n";
+        return false;
+    }
+
+    return m_simpleCoverDatabase.writeCache(coverCacheFileName());
+}
+
 bool Id3Repository::isCached(const std::string &url) const {
     logger(LoggerFramework::Level::debug) << "cache test for url <"<<url<<">\n";
     return std::find_if(std::cbegin(m_simpleDatabase), std::cend(m_simpleDatabase),
@@ -433,13 +602,22 @@ bool Id3Repository::isCached(const std::string &url) const {
 }
 
 bool Id3Repository::remove(const boost::uuids::uuid& uniqueID) {
-    auto it = std::find_if(std::begin(m_simpleDatabase),
-                           std::end(m_simpleDatabase),
-                           [&uniqueID](const Id3Info& info) { return info.uid == uniqueID; });
-    if (it != std::end(m_simpleDatabase)) {
+    if (auto position = m_uidIndex.find(uniqueID)) {
         logger(Level::debug) << "removing audio file id <" << uniqueID
-                             << "> Title: "<<it->title_name << " from database\n";
-        m_simpleDatabase.erase(it);
+                             << "> Title: "<<m_simpleDatabase[*position].title_name << " from database\n";
+        // move the last entry into the gap, so only one entry needs to be reindexed
+        auto lastPosition { m_simpleDatabase.size()-1 };
+        unindexEntry(*position);
+        if (*position != lastPosition) {
+            unindexEntry(lastPosition);
+            m_simpleDatabase[*position] = std::move(m_simpleDatabase.back());
+            m_addedSequence[*position] = m_addedSequence[lastPosition];
+            indexEntry(*position);
+        }
+        m_simpleDatabase.pop_back();
+        m_addedSequence.pop_back();
+        m_simpleCoverDatabase.removeUid(uniqueID);
+        m_generation = m_changeLog.record(ChangeLog::Kind::removed, uniqueID);
         m_cache_dirty = true;
         return true;
     }
@@ -447,141 +625,487 @@ bool Id3Repository::remove(const boost::uuids::uuid& uniqueID) {
     return false;
 }
 
+std::size_t Id3Repository::collectCoverGarbage() {
+    auto removed = m_simpleCoverDatabase.collectGarbage();
+    if (removed > 0) {
+        // the cover cache must not refer to the removed covers, the audio items are unchanged
+        writeCoverCache();
+        removeOrphanCoverFiles();
+    }
+    return removed;
+}
+
+std::size_t Id3Repository::removeOrphanCoverFiles() const {
+    if (!m_enableCache)
+        return 0;
+    return m_simpleCoverDatabase.removeOrphanFiles();
+}
+
 void Id3Repository::clear() {
     m_simpleDatabase.clear();
+    m_uidIndex.clear();
+    m_titleIndex.clear();
+    m_albumIndex.clear();
+    m_performerIndex.clear();
+    m_albumTitleIndex.clear();
+    m_facets.clear();
+    m_addedSequence.clear();
+    m_columnsDirty = true;
+    m_completionDirty = true;
+    m_ordersDirty = true;
     m_cache_dirty = true;
+    m_generation = m_changeLog.truncate();
 }
 
-std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> Id3Repository::findDuplicates() {
+namespace {
 
-    if (m_simpleDatabase.size() < 1)
-        return {};
+constexpr std::size_t contentChunkSize { 64*1024 };
+
+// hash of the file content, read chunk by chunk
+std::optional<uint64_t> contentHash(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        return std::nullopt;
+    std::vector<char> chunk(contentChunkSize);
+    uint64_t hash { Common::genHash64(nullptr, 0) };
+    while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0)
+        hash = Common::genHash64(chunk.data(), static_cast<std::size_t>(file.gcount()), hash);
+    if (file.bad())
+        return std::nullopt;
+    return hash;
+}
+
+bool sameContent(const std::string& filename1, const std::string& filename2) {
+    std::ifstream file1(filename1, std::ios::binary);
+    std::ifstream file2(filename2, std::ios::binary);
+    if (!file1 || !file2)
+        return false;
+    std::vector<char> chunk1(contentChunkSize);
+    std::vector<char> chunk2(contentChunkSize);
+    while (true) {
+        file1.read(chunk1.data(), static_cast<std::streamsize>(chunk1.size()));
+        file2.read(chunk2.data(), static_cast<std::streamsize>(chunk2.size()));
+        auto count = file1.gcount();
+        if (count != file2.gcount() || std::memcmp(chunk1.data(), chunk2.data(), static_cast<std::size_t>(count)) != 0)
+            return false;
+        if (count == 0 || !file1 || !file2)
+            return !file1.bad() && !file2.bad() && file1.eof() == file2.eof();
+    }
+}
+
+}
+
+std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> Id3Repository::findDuplicates(DuplicateKey key) const {
+
+    // rows of each group, a group is created by its first row, so the groups are in storage order
+    std::vector<std::vector<std::size_t>> groupList;
+
+    if (key == DuplicateKey::tags) {
+        std::unordered_map<std::string, std::size_t> groupPosition;
+        for (std::size_t row{0}; row < m_simpleDatabase.size(); ++row) {
+            const auto& info = m_simpleDatabase[row];
+            std::string groupKey;
+            groupKey.reserve(info.getNormalizedTitle().length() + info.getNormalizedAlbum().length() + info.getNormalizedPerformer().length() + 2);
+            groupKey.append(info.getNormalizedTitle()).append(1, '\0').append(info.getNormalizedAlbum()).append(1, '\0').append(info.getNormalizedPerformer());
+            auto [positionIt, isNew] = groupPosition.try_emplace(std::move(groupKey), groupList.size());
+            if (isNew)
+                groupList.emplace_back();
+            groupList[positionIt->second].push_back(row);
+        }
+    }
+    else {
+        // the file size is cheap, so only files with the same size are read to build their hash
+        std::unordered_map<uintmax_t, std::vector<std::size_t>> sizeGroup;
+        for (std::size_t row{0}; row < m_simpleDatabase.size(); ++row) {
+            const auto& source = m_simpleDatabase[row].informationSource;
+            if (source.substr(0, ServerConstant::fileprefix.length()) != ServerConstant::fileprefix)
+                continue;
+            boost::system::error_code ec;
+            auto size = fs::file_size(source.substr(ServerConstant::fileprefix.length()), ec);
+            if (!ec)
+                sizeGroup[size].push_back(row);
+        }
 
-    std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> dublicateList;
-
-    for(auto it{ std::cbegin(m_simpleDatabase) }; it != std::cend(m_simpleDatabase); ++it) {
-        /* find dublicats within following entries */
-        for(auto dub { it + 1 }; dub != std::cend(m_simpleDatabase); ++dub) {
-            if (*it == *dub) {
-                auto dublicatList = std::find_if(std::begin(dublicateList),
-                                                 std::end(dublicateList), [&it](const auto& elem)
-                { return std::get<Id3Info>(elem) == *it; });
-                if ( dublicatList != std::end(dublicateList)) {
-                    std::tuple<Id3Info, std::vector<boost::uuids::uuid>> entry {*dublicatList};
-                    auto list { std::get<std::vector<boost::uuids::uuid>>(entry) };
-                    list.push_back(dub->uid);
+        auto filename = [this](std::size_t row) { return m_simpleDatabase[row].informationSource.substr(ServerConstant::fileprefix.length()); };
+
+        for (const auto& [size, rowList] : sizeGroup) {
+            if (rowList.size() < 2)
+                continue;
+            // files with the same hash are compared byte by byte with the first file of every group
+            std::unordered_map<uint64_t, std::vector<std::size_t>> groupPosition;
+            for (auto row : rowList) {
+                auto hash = contentHash(filename(row));
+                if (!hash) {
+                    logger(Level::warning) << "cannot read <" << m_simpleDatabase[row].informationSource << "> for duplicate check\n";
+                    continue;
+                }
+                auto& positionList = groupPosition[*hash];
+                auto position = std::find_if(std::begin(positionList), std::end(positionList), [&](std::size_t position)
+                                             { return sameContent(filename(groupList[position].front()), filename(row)); });
+                if (position != std::end(positionList)) {
+                    groupList[*position].push_back(row);
                 }
                 else {
-                    Id3Info info {*it};
-                    auto entryIt = dublicateList.insert(std::cbegin(dublicateList),
-                                                        std::make_tuple<Id3Info, std::vector<boost::uuids::uuid>> (std::move(info), {}));
-                    std::tuple<Id3Info, std::vector<boost::uuids::uuid>>& entry {*entryIt};
-                    auto list { std::get<std::vector<boost::uuids::uuid>>(entry) };
-                    list.push_back(dub->uid);
+                    positionList.push_back(groupList.size());
+                    groupList.push_back({row});
                 }
             }
         }
+        std::sort(std::begin(groupList), std::end(groupList),
+                  [](const auto& group1, const auto& group2) { return group1.front() < group2.front(); });
     }
-    return dublicateList;
+
+    std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> duplicateList;
+
+    for (const auto& group : groupList) {
+        if (group.size() < 2)
+            continue;
+        std::vector<boost::uuids::uuid> uidList;
+        uidList.reserve(group.size() - 1);
+        for (auto it = std::next(std::begin(group)); it != std::end(group); ++it)
+            uidList.push_back(m_simpleDatabase[*it].uid);
+        duplicateList.emplace_back(m_simpleDatabase[group.front()], std::move(uidList));
+    }
+
+    logger(Level::info) << "found <" << duplicateList.size() << "> groups of duplicates\n";
+
+    return duplicateList;
 }
 
-std::vector<Id3Info> Id3Repository::search(const boost::uuids::uuid &what, SearchItem , SearchAction action) {
+ResultList<Id3Info> Id3Repository::find(const boost::uuids::uuid &what, SearchItem , SearchAction action) const {
 
-    std::vector<Id3Info> findData;
+    ResultList<Id3Info> findData;
 
     if (action == SearchAction::uniqueId) {
-        try {
-            std::for_each(std::begin(m_simpleDatabase), std::end(m_simpleDatabase),
-                          [&what, &findData](const Id3Info &info) {
-                if (info.uid == what) {
-                    logger(Level::debug) << "found uniqueId search: " << info.toString() <<"\n";
-                    findData.push_back(info);
-                }
-            });
-        } catch (std::exception& ex) {
-            logger(Level::warning) << "cannot convert Uid <"<<what<<">: "<<ex.what()<<"\n";
+        if (const auto info = findByUid(what)) {
+            logger(Level::debug) << "found uniqueId search: " << info->toString() <<"\n";
+            findData.push_back(*info);
         }
     }
 
     return findData;
 }
 
-std::vector<Id3Info> Id3Repository::upn(std::vector<std::string>& whatList, SearchItem item) {
+std::string Id3Repository::albumTitleKey(const boost::uuids::uuid& albumUid, std::string_view normalizedTitle) {
+    std::string key(reinterpret_cast<const char*>(albumUid.data), albumUid.size());
+    key.append(normalizedTitle);
+    return key;
+}
 
-    std::stack<std::string> stack;
-    std::vector<Id3Info> retList;
+void Id3Repository::indexEntry(std::size_t position, bool withSearchIndexes) {
+    const auto& info = m_simpleDatabase[position];
+    auto row = static_cast<TrigramIndex::RowId>(position);
+    if (withSearchIndexes) {
+        m_uidIndex.insert(info.uid, position);
+        m_titleIndex.add(row, info.getNormalizedTitle());
+        m_albumIndex.add(row, info.getNormalizedAlbum());
+        m_performerIndex.add(row, info.getNormalizedPerformer());
+    }
+    if (info.albumCreation)
+        m_albumTitleIndex.emplace(albumTitleKey(Common::albumPlaylistUid(info.getNormalizedAlbum()), info.getNormalizedTitle()), row);
+    m_facets.add(info);
+
+    // appending at the end keeps the columns valid, any other change needs a rebuild
+    if (!m_columnsDirty && position == m_titleColumn.rows()) {
+        m_titleColumn.append(info.getNormalizedTitle());
+        m_albumColumn.append(info.getNormalizedAlbum());
+        m_performerColumn.append(info.getNormalizedPerformer());
+    }
+    else {
+        m_columnsDirty = true;
+    }
+    m_completionDirty = true;
+    m_ordersDirty = true;
+    m_generation = m_changeLog.next();
+
+    // a moved entry keeps its sequence number, only new entries get one
+    if (position == m_addedSequence.size()) {
+        m_addedSequence.push_back(m_nextSequence++);
+        m_generation = m_changeLog.record(ChangeLog::Kind::added, info.uid);
+    }
+}
 
-    if (whatList.size() < 2) {
-        return retList;
+void Id3Repository::unindexEntry(std::size_t position) {
+    const auto& info = m_simpleDatabase[position];
+    auto row = static_cast<TrigramIndex::RowId>(position);
+    m_uidIndex.erase(info.uid);
+    m_titleIndex.remove(row, info.getNormalizedTitle());
+    m_albumIndex.remove(row, info.getNormalizedAlbum());
+    m_performerIndex.remove(row, info.getNormalizedPerformer());
+    if (info.albumCreation) {
+        auto [begin, end] = m_albumTitleIndex.equal_range(albumTitleKey(Common::albumPlaylistUid(info.getNormalizedAlbum()), info.getNormalizedTitle()));
+        auto it = std::find_if(begin, end, [row](const auto& entry) { return entry.second == row; });
+        if (it != end)
+            m_albumTitleIndex.erase(it);
     }
+    m_facets.remove(info);
+    m_columnsDirty = true;
+    m_completionDirty = true;
+    m_ordersDirty = true;
+    m_generation = m_changeLog.next();
+}
 
-    for (auto& it : whatList) {
-        if (it == "&" || it=="|") {
-            if (stack.size() < 2) {
-                logger (Level::warning) << "UPN failed\n";
-                break;
-            }
-            auto value1 = stack.top();
-            stack.pop();
-            auto value2 = stack.top();
-            stack.pop();
-
-            std::for_each(std::begin(m_simpleDatabase), std::end(m_simpleDatabase),[&value1, &value2, &item, &it, &retList](const Id3Info& info){
-                if (it == "&") {
-
-                    if (((item == SearchItem::title || item == SearchItem::overall) &&
-                         (info.title_name.find(value1) != std::string::npos &&
-                          info.title_name.find(value2) != std::string::npos)) ||
-                            ((item == SearchItem::album || item == SearchItem::overall) &&
-                             (info.album_name.find(value1) != std::string::npos &&
-                              info.album_name.find(value2) != std::string::npos)) ||
-                            ((item == SearchItem::performer || item == SearchItem::overall) &&
-                             (info.performer_name.find(value1) != std::string::npos &&
-                              info.performer_name.find(value2) != std::string::npos)
-                             )) {
-                        retList.push_back(info);
-                    }
+std::optional<QueryBitSet> Id3Repository::searchAlikeIndexed(const std::vector<std::string>& whatList, SearchItem item) const {
 
-                }
-                if (it == "|") {
-                    if (((item == SearchItem::title || item == SearchItem::overall) &&
-                         (info.title_name.find(value1) != std::string::npos ||
-                          info.title_name.find(value2) != std::string::npos)) ||
-                            ((item == SearchItem::album || item == SearchItem::overall) &&
-                             (info.album_name.find(value1) != std::string::npos ||
-                              info.album_name.find(value2) != std::string::npos)) ||
-                            ((item == SearchItem::performer || item == SearchItem::overall) &&
-                             (info.performer_name.find(value1) != std::string::npos ||
-                              info.performer_name.find(value2) != std::string::npos)
-                             )) {
-                        retList.push_back(info);
-                    }
-                }
-            });
-        } else {
-            stack.push(it);
+    // the index can only answer the request, if every search word is long enough
+    if (whatList.empty() ||
+            !std::all_of(std::begin(whatList), std::end(whatList), [](const std::string& what) { return TrigramIndex::isIndexable(what); }))
+        return std::nullopt;
+
+    // any of the words matches
+    QueryBitSet result(m_simpleDatabase.size());
+    for (const auto& what : whatList)
+        result |= matchAlike(what, item);
+
+    return result;
+}
+
+QueryBitSet Id3Repository::matchAlike(const std::string& what, SearchItem item) const {
+
+    if (!TrigramIndex::isIndexable(what))
+        return scanAlike({what}, item);
+
+    QueryBitSet result(m_simpleDatabase.size());
+
+    bool withTitle = (item == SearchItem::title || item == SearchItem::overall);
+    bool withAlbum = (item == SearchItem::album || item == SearchItem::overall || item == SearchItem::album_and_interpret);
+    bool withPerformer = (item == SearchItem::performer || item == SearchItem::overall || item == SearchItem::album_and_interpret);
+
+    auto match = [this, &what, &result](const TrigramIndex& index, const std::string& (Id3Info::*field)() const) {
+        auto candidateList = index.candidates(what);
+        for (const auto& row : *candidateList) {
+            if ((m_simpleDatabase[row].*field)().find(what) != std::string::npos)
+                result.set(row);
         }
+    };
+
+    if (withTitle)
+        match(m_titleIndex, &Id3Info::getNormalizedTitle);
+
+    if (withAlbum) {
+        match(m_albumIndex, &Id3Info::getNormalizedAlbum);
+
+        matchTags({what}, result);
+    }
+
+    if (withPerformer)
+        match(m_performerIndex, &Id3Info::getNormalizedPerformer);
+
+    return result;
+}
+
+void Id3Repository::matchTags(const std::vector<std::string>& whatList, QueryBitSet& result) const {
+
+    // tags are not part of the text index, only walk through the (short) tag lists
+    auto tagMask = TagConverter::getTagMaskAlike(whatList);
+    if (tagMask == 0)
+        return;
+
+    for (std::size_t row{0}; row < m_simpleDatabase.size(); ++row) {
+        if (m_simpleDatabase[row].hasAnyTag(tagMask))
+            result.set(row);
+    }
+}
+
+QueryBitSet Id3Repository::scanAlike(const std::vector<std::string>& whatList, SearchItem item) const {
+
+    refreshColumns();
 
+    QueryBitSet result(m_simpleDatabase.size());
+
+    if (item == SearchItem::title || item == SearchItem::overall)
+        m_titleColumn.findAny(whatList, result);
+
+    if (item == SearchItem::album || item == SearchItem::overall || item == SearchItem::album_and_interpret) {
+        m_albumColumn.findAny(whatList, result);
+
+        matchTags(whatList, result);
+    }
+
+    if (item == SearchItem::performer || item == SearchItem::overall || item == SearchItem::album_and_interpret)
+        m_performerColumn.findAny(whatList, result);
+
+    return result;
+}
+
+void Id3Repository::refreshColumns() const {
+
+    if (!m_columnsDirty)
+        return;
+
+    for (auto column : { &m_titleColumn, &m_albumColumn, &m_performerColumn }) {
+        column->clear();
+        column->reserve(m_simpleDatabase.size(), 0);
+    }
+
+    for (const auto& info : m_simpleDatabase) {
+        m_titleColumn.append(info.getNormalizedTitle());
+        m_albumColumn.append(info.getNormalizedAlbum());
+        m_performerColumn.append(info.getNormalizedPerformer());
+    }
+
+    m_columnsDirty = false;
+}
+
+void Id3Repository::refreshCompletion() const {
+
+    if (!m_completionDirty)
+        return;
+
+    m_completionIndex.clear();
+    for (const auto& info : m_simpleDatabase) {
+        m_completionIndex.addText(info.getNormalizedTitle());
+        m_completionIndex.addText(info.getNormalizedAlbum());
+        m_completionIndex.addText(info.getNormalizedPerformer());
+    }
+    m_completionIndex.seal();
+
+    logger(Level::debug) << "completion index rebuilt with <" << m_completionIndex.size() << "> words\n";
+
+    m_completionDirty = false;
+}
+
+void Id3Repository::refreshOrders() const {
+
+    if (!m_ordersDirty)
+        return;
+
+    m_titleOrder = buildOrder(m_simpleDatabase.size(), [this](uint32_t row1, uint32_t row2) {
+        return m_simpleDatabase[row1].getNormalizedTitle() < m_simpleDatabase[row2].getNormalizedTitle();
+    });
+    m_performerOrder = buildOrder(m_simpleDatabase.size(), [this](uint32_t row1, uint32_t row2) {
+        const auto& info1 = m_simpleDatabase[row1];
+        const auto& info2 = m_simpleDatabase[row2];
+        return std::forward_as_tuple(info1.getNormalizedPerformer(), info1.getNormalizedAlbum(), info1.track_no) <
+                std::forward_as_tuple(info2.getNormalizedPerformer(), info2.getNormalizedAlbum(), info2.track_no);
+    });
+    m_addedOrder = buildOrder(m_simpleDatabase.size(), [this](uint32_t row1, uint32_t row2) {
+        return m_addedSequence[row1] > m_addedSequence[row2];
+    });
+
+    m_ordersDirty = false;
+}
+
+const std::vector<uint32_t>& Id3Repository::order(SortOrder sortOrder) const {
+    refreshOrders();
+    switch (sortOrder) {
+    case SortOrder::performer:
+        return m_performerOrder;
+    case SortOrder::added:
+        return m_addedOrder;
+    default:
+        return m_titleOrder;
+    }
+}
+
+int Id3Repository::relevance(std::size_t row, const std::vector<std::string>& whatList) const {
+    const auto& info = m_simpleDatabase[row];
+    int score {0};
+    for (const auto& what : whatList) {
+        score += Common::matchScore(info.getNormalizedTitle(), what);
+        score += Common::matchScore(info.getNormalizedAlbum(), what);
+        score += Common::matchScore(info.getNormalizedPerformer(), what);
+    }
+    return score;
+}
+
+ResultList<Id3Info> Id3Repository::paginate(const ResultList<Id3Info>& findData, const std::vector<std::string>& whatList, const PageRequest& page) const {
+    return Database::paginate(findData, m_simpleDatabase, page,
+                              [this](SortOrder sortOrder) -> const std::vector<uint32_t>& { return order(sortOrder); },
+                              [this, &whatList](std::size_t row) { return relevance(row, whatList); });
+}
+
+ResultList<Id3Info> Id3Repository::find(const std::string &what, SearchItem item, SearchAction action, const PageRequest& page) const {
+    return paginate(find(what, item, action), Common::extractWhatList(what), page);
+}
+
+ResultList<Id3Info> Id3Repository::find(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList,
+                                        SearchAction action, const PageRequest& page) const {
+    std::vector<std::string> whatList;
+    for (const auto& [item, what] : criteriaList) {
+        auto criteriaWhatList = Common::extractWhatList(what);
+        whatList.insert(std::end(whatList), std::begin(criteriaWhatList), std::end(criteriaWhatList));
+    }
+    return paginate(find(criteriaList, action), whatList, page);
+}
+
+std::vector<std::string> Id3Repository::complete(const std::string& prefix, CompletionIndex::State& state, std::size_t limit) const {
+    refreshCompletion();
+    return m_completionIndex.complete(Common::normalize(prefix), state, limit);
+}
+
+QueryBitSet Id3Repository::matchExact(const std::string& what, SearchItem item) const {
+
+    QueryBitSet result(m_simpleDatabase.size());
+    auto whatLower = Common::normalize(what);
+
+    for (std::size_t row{0}; row < m_simpleDatabase.size(); ++row) {
+        if (matchesExact(m_simpleDatabase[row], whatLower, item))
+            result.set(row);
+    }
+
+    return result;
+}
+
+bool Id3Repository::matchesExact(const Id3Info& info, const std::string& whatLower, SearchItem item) {
+    return ((item == SearchItem::title || item == SearchItem::overall) &&
+            (info.getNormalizedTitle() == whatLower)) ||
+            ((item == SearchItem::album || item == SearchItem::overall) &&
+             (info.getNormalizedAlbum() == whatLower)) ||
+            ((item == SearchItem::performer || item == SearchItem::overall) &&
+             (info.getNormalizedPerformer() == whatLower));
+}
+
+ResultList<Id3Info> Id3Repository::collect(const QueryBitSet& result) const {
+    ResultList<Id3Info> findData;
+    findData.reserve(result.count());
+    result.forEach([this, &findData](std::size_t row) { findData.push_back(m_simpleDatabase[row]); });
+    return findData;
+}
+
+ResultList<Id3Info> Id3Repository::find(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const {
+
+    if (criteriaList.empty())
+        return {};
+
+    QueryBitSet result(m_simpleDatabase.size(), true);
+
+    for (const auto& [item, what] : criteriaList) {
+        if (action == SearchAction::alike) {
+            // plain words are searched like a single criterion, any of the words matches
+            auto whatList = Common::extractWhatList(what);
+            if (!Query::isExpression(whatList)) {
+                auto indexedResult = searchAlikeIndexed(whatList, item);
+                result &= indexedResult ? *indexedResult : scanAlike(whatList, item);
+            }
+            else if (auto query = Query::compile(whatList)) {
+                result &= query->evaluate(m_simpleDatabase.size(), [this, item = item](const std::string& word) { return matchAlike(word, item); });
+            }
+            else {
+                logger(Level::warning) << "invalid search expression <" << what << ">\n";
+                return {};
+            }
+        }
+        else {
+            result &= matchExact(what, item);
+        }
     }
 
-    return retList;
+    return collect(result);
 }
 
-std::vector<Id3Info> Id3Repository::search(const std::string &what, SearchItem item, SearchAction action) {
+ResultList<Id3Info> Id3Repository::find(const std::string &what, SearchItem item, SearchAction action) const {
 
-    std::vector<Id3Info> findData;
+    ResultList<Id3Info> findData;
 
     if (action == SearchAction::uniqueId || item == SearchItem::uid) {
         logger(Level::info) << "searching uid (" << what << ")\n";
         try {
             auto whatUuid = boost::lexical_cast<boost::uuids::uuid>(what);
-            std::for_each(std::begin(m_simpleDatabase), std::end(m_simpleDatabase),
-                          [&whatUuid, &findData](const Id3Info &info) {
-                if (info.uid == whatUuid) {
-                    logger(Level::info) << "found uniqueId search: " << info.toString() <<"\n";
-                    findData.push_back(info);
-                }
-            });
+            if (const auto info = findByUid(whatUuid)) {
+                logger(Level::info) << "found uniqueId search: " << info->toString() <<"\n";
+                findData.push_back(*info);
+            }
         } catch (std::exception& ex) {
             logger(Level::warning) << "cannot convert Uid <"<<what<<">: "<<ex.what()<<"\n";
         }
@@ -589,102 +1113,116 @@ std::vector<Id3Info> Id3Repository::search(const std::string &what, SearchItem i
     else {
         auto whatList = Common::extractWhatList(what);
 
-        bool is_upn{false};
-        std::for_each (std::begin(whatList), std::end(whatList), [&is_upn](const std::string& index){
-            if (index == "&" || index == "|")
-                is_upn = true;
-        });
+        std::optional<Query> query;
+        if (action == SearchAction::alike && Query::isExpression(whatList)) {
+            query = Query::compile(whatList);
+            if (!query)
+                logger(Level::warning) << "invalid search expression <" << what << ">, searching for the plain words\n";
+        }
 
-        if(item == SearchItem::overall && action == SearchAction::alike && is_upn) {
-//                ( what.find_first_of(" & ") != std::string::npos ||
-//                  what.find_first_of(" | ") != std::string::npos )
-//                ) {
-            findData = upn(whatList, item);
+        if (query) {
+            findData = collect(query->evaluate(m_simpleDatabase.size(), [this, item](const std::string& word) { return matchAlike(word, item); }));
+        }
+        else if (auto indexedResult = (action == SearchAction::alike) ? searchAlikeIndexed(whatList, item) : std::nullopt) {
+            findData = collect(*indexedResult);
+        }
+        else if (action == SearchAction::alike) {
+            findData = collect(scanAlike(whatList, item));
         }
         else {
-
-            std::for_each(std::begin(m_simpleDatabase), std::end(m_simpleDatabase),
-                          [&whatList, &what, &findData, item, action](const Id3Info &info) {
-                if (action == SearchAction::alike) {
-                    if (((item == SearchItem::title || item == SearchItem::overall) &&
-                         (info.isAlikeTitle(whatList))) ||
-                            ((item == SearchItem::album || item == SearchItem::overall || item == SearchItem::album_and_interpret) &&
-                             (info.isAlikeAlbum(whatList))) ||
-                            ((item == SearchItem::album || item == SearchItem::overall || item == SearchItem::album_and_interpret) &&
-                             (info.isAlikeTag(whatList))) ||
-                            ((item == SearchItem::performer || item == SearchItem::overall || item == SearchItem::album_and_interpret) &&
-                             (info.isAlikePerformer(whatList)))) {
-                        findData.push_back(info);
-                    }
-                }
-                else {
-//                    logger(Level::info) << "exact search\n";
-                    if (((item == SearchItem::title || item == SearchItem::overall) &&
-                         (info.getNormalizedTitle() == Common::str_tolower(what))) ||
-                            ((item == SearchItem::album || item == SearchItem::overall) &&
-                             (info.getNormalizedAlbum() == Common::str_tolower(what))) ||
-                            ((item == SearchItem::performer || item == SearchItem::overall) &&
-                             (info.getNormalizedPerformer() == Common::str_tolower(what)))) {
-                        findData.push_back(info);
-                    }
-                }
-            });
+            findData = collect(matchExact(what, item));
         }
     }
     return findData;
 }
 
-std::vector<Common::AlbumListEntry> Id3Repository::extractAlbumList() {
-    std::vector<AlbumListEntry> albumList;
+std::vector<Id3Info> Id3Repository::search(const boost::uuids::uuid &what, SearchItem item, SearchAction action) const {
+    return find(what, item, action).toVector();
+}
 
-    for(auto it {std::cbegin(m_simpleDatabase)}; it != std::cend(m_simpleDatabase); ++it) {
+std::vector<Id3Info> Id3Repository::search(const std::string &what, SearchItem item, SearchAction action) const {
+    return find(what, item, action).toVector();
+}
 
-        if (it->albumCreation) {
+std::vector<Id3Info> Id3Repository::search(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList, SearchAction action) const {
+    return find(criteriaList, action).toVector();
+}
 
-            auto albumIt = std::find_if(std::begin(albumList), std::end(albumList), [&it](const AlbumListEntry& albumListEntry)
-            { return albumListEntry.m_name == it->album_name; });
+std::vector<Common::AlbumListEntry> Id3Repository::extractAlbumList() const {
+    std::vector<AlbumListEntry> albumList;
+    std::unordered_map<std::string, std::size_t> albumPosition; //< normalized album name -> position in albumList
 
-            if (albumIt == std::cend(albumList)) {
-                AlbumListEntry entry;
-                entry.m_name = it->album_name;
-                entry.m_performer = it->performer_name;
-                entry.m_tagList = it->tags;
-                entry.m_coverUrl = it->urlCoverFile;
-                entry.m_playlist.push_back(std::make_tuple(it->uid, it->cd_no*1000 + it->track_no));
-                albumList.emplace_back(entry);
-            }
-            else {
-                if (it->performer_name != albumIt->m_performer) {
-                    albumIt->m_performer = "multiple performer";
-                }
-                if (albumIt->m_coverUrl.empty() && !it->urlCoverFile.empty()) {
-                    albumIt->m_coverUrl = it->urlCoverFile;
-                }
+    for (const auto& info : m_simpleDatabase) {
 
-                albumIt->m_playlist.push_back(std::make_tuple(it->uid, it->cd_no*1000 + it->track_no));
-                albumIt->m_tagList = it->tags;
-            }
+        if (!info.albumCreation)
+            continue;
+
+        auto [positionIt, isNew] = albumPosition.try_emplace(info.getNormalizedAlbum(), albumList.size());
+
+        if (isNew) {
+            AlbumListEntry entry;
+            entry.m_uid = Common::albumPlaylistUid(info.getNormalizedAlbum());
+            entry.m_name = info.album_name;
+            entry.m_performer = info.performer_name;
+            entry.m_coverUrl = info.urlCoverFile;
+            albumList.emplace_back(std::move(entry));
         }
-    }
-    logger(Level::info) << "extracted <"<<albumList.size()<<"> album playlists\n";
-    for (auto& i : albumList) {
-        std::sort(std::begin(i.m_playlist), std::end(i.m_playlist), [](const auto& t1, const auto& t2)
-        { return std::get<uint32_t>(t1) < std::get<uint32_t>(t2); });
 
+        auto& album = albumList[positionIt->second];
+        if (!isNew && info.performer_name != album.m_performer)
+            album.m_performer = "multiple performer";
+        if (album.m_coverUrl.empty() && !info.urlCoverFile.empty())
+            album.m_coverUrl = info.urlCoverFile;
+        album.m_tagList = info.getTags();
+
+        // keep the track order on insert
+        auto track = std::make_tuple(info.uid, info.getAlbumPosition());
+        auto insertIt = std::upper_bound(std::begin(album.m_playlist), std::end(album.m_playlist), track,
+                                         [](const auto& t1, const auto& t2) { return std::get<uint32_t>(t1) < std::get<uint32_t>(t2); });
+        album.m_playlist.insert(insertIt, std::move(track));
     }
 
+    logger(Level::info) << "extracted <"<<albumList.size()<<"> album playlists\n";
+
     return albumList;
 }
 
-std::optional<Id3Info> Id3Repository::getId3InfoByUid(const boost::uuids::uuid& uniqueId) const {
-    auto it = std::find_if(std::begin(m_simpleDatabase),
-                           std::end(m_simpleDatabase),
-                           [&uniqueId](const Id3Info& info) { return info.uid == uniqueId; });
+const Id3Info* Id3Repository::findByUid(const boost::uuids::uuid& uniqueId) const {
+    if (auto position = m_uidIndex.find(uniqueId))
+        return &m_simpleDatabase[*position];
+    return nullptr;
+}
 
-    if (it==std::end(m_simpleDatabase))
-        return std::nullopt;
-    else
-        return *it;
+ResultList<Id3Info> Id3Repository::findByUidList(const std::vector<boost::uuids::uuid>& uidList) const {
+    ResultList<Id3Info> findData;
+    findData.reserve(uidList.size());
+    m_uidIndex.findEach(uidList, [this, &findData](const boost::uuids::uuid& uid, std::optional<std::size_t> position) {
+        if (position)
+            findData.push_back(m_simpleDatabase[*position]);
+        else
+            logger(Level::debug) << "uuid <" << uid << "> not found in repository\n";
+    });
+    return findData;
+}
+
+ResultList<Id3Info> Id3Repository::findByAlbumTitle(const boost::uuids::uuid& albumUid, const std::string& title) const {
+    auto [begin, end] = m_albumTitleIndex.equal_range(albumTitleKey(albumUid, Common::normalize(title)));
+    std::vector<uint32_t> rowList;
+    std::transform(begin, end, std::back_inserter(rowList), [](const auto& entry) { return entry.second; });
+    // equal keys are not kept in any order, give them in storage order
+    std::sort(std::begin(rowList), std::end(rowList));
+
+    ResultList<Id3Info> findData;
+    findData.reserve(rowList.size());
+    for (auto row : rowList)
+        findData.push_back(m_simpleDatabase[row]);
+    return findData;
+}
+
+std::optional<Id3Info> Id3Repository::getId3InfoByUid(const boost::uuids::uuid& uniqueId) const {
+    if (const auto info = findByUid(uniqueId))
+        return *info;
+    return std::nullopt;
 }
 
 bool Id3Repository::read() {
@@ -723,17 +1261,44 @@ bool Id3Repository::read() {
 
     logger(Level::info) << "database read completed\n";
 
+    logStringPoolUsage();
+
     writeCacheInternal();
 
     return true;
 }
 
+void Id3Repository::logStringPoolUsage() const {
+
+    // memory the interned fields would occupy as separate std::string objects
+    std::size_t plainBytes {0};
+    std::size_t internedFields {0};
+    for (const auto& info : m_simpleDatabase) {
+        for (const auto& field : { std::cref(info.album_name.str()), std::cref(info.getNormalizedAlbum()),
+                                   std::cref(info.performer_name.str()), std::cref(info.getNormalizedPerformer()),
+                                   std::cref(info.informationSource.str()), std::cref(info.urlAudioFile.str()),
+                                   std::cref(info.audioFileExt.str()), std::cref(info.urlCoverFile.str()),
+                                   std::cref(info.coverFileExt.str()) }) {
+            plainBytes += Common::StringPool::stringMemory(field);
+            ++internedFields;
+        }
+    }
+
+    const auto& pool = Common::StringPool::instance();
+    std::size_t internedBytes = internedFields * sizeof(Common::InternedString) + pool.memoryUsage();
+
+    logger(Level::info) << "string pool: <" << pool.size() << "> distinct strings for <" << internedFields
+                        << "> fields, <" << internedBytes << "> bytes instead of <" << plainBytes << "> bytes, saved <"
+                        << (plainBytes > internedBytes ? plainBytes - internedBytes : 0) << "> bytes\n";
+}
+
 bool Id3Repository::writeCache() {
     return writeCacheInternal();
 }
 
 void Id3Repository::addTags(const SongTagReader& songTagReader)
 {
+    m_generation = m_changeLog.next();
     for (auto& elem : m_simpleDatabase) {
         auto tagList = songTagReader.findSongTagList( elem.getNormalizedAlbum(),
                                                         elem.getNormalizedTitle(),
@@ -744,7 +1309,10 @@ void Id3Repository::addTags(const SongTagReader& songTagReader)
                 tagString += "<" + TagConverter::getTagName(str) + ">";
             }
             logger(Level::debug) << "adding tags ("<<tagString<<") to "<<elem.toString()<<"\n";
+            m_facets.remove(elem);
             elem.setTags(std::move(tagList));
+            m_facets.add(elem);
+            m_generation = m_changeLog.record(ChangeLog::Kind::modified, elem.uid);
         }
     }
 
@@ -765,31 +1333,112 @@ bool CoverElement::isConnectedToUid(const boost::uuids::uuid &uid) const {
                         [&uid](const boost::uuids::uuid& elem) { return uid == elem; } ) != std::cend(uidListForCover);
 }
 
+bool CoverElement::removeUid(const boost::uuids::uuid &uid) {
+    auto it = std::find(std::begin(uidListForCover), std::end(uidListForCover), uid);
+    if (it == std::end(uidListForCover))
+        return false;
+    uidListForCover.erase(it);
+    return true;
+}
+
+void CoverDatabase::indexCoverElement(std::size_t position) {
+    const auto& elem = m_simpleCoverDatabase[position];
+    for (const auto& uid : elem.uidListForCover)
+        m_uidIndex.insert(uid, position);
+    m_hashIndex[elem.hash] = position;
+    if (elem.isOrphan())
+        ++m_orphanCount;
+}
+
 bool CoverDatabase::addCover(std::vector<char> &&rawData, const boost::uuids::uuid &_uid) {
     auto uid {_uid};
     std::size_t hash = Common::genHash(rawData);
 
-    auto it = std::find_if(std::begin(m_simpleCoverDatabase), std::end(m_simpleCoverDatabase),
-                           [&hash](const CoverElement& elem) { return hash == elem.hash; } );
-
     // is there a cover with this hash?
-    if (it != std::cend(m_simpleCoverDatabase)) {
-        // add the current audio uid
-        it->insertNewUid(std::move(uid));
+    auto it = m_hashIndex.find(hash);
+    if (it != std::end(m_hashIndex)) {
+        // add the current audio uid, an orphaned cover is used again
+        auto& elem = m_simpleCoverDatabase[it->second];
+        if (elem.isOrphan())
+            --m_orphanCount;
+        m_uidIndex.insert(uid, it->second);
+        elem.insertNewUid(std::move(uid));
         return true;
     }
 
     // if cover not found (by hash), create new cover element
     CoverElement elem;
     elem.hash = hash;
-    elem.rawData = move(std::move(rawData));
+    elem.rawData = std::make_shared<const std::vector<char>>(std::move(rawData));
     elem.insertNewUid(std::move(uid));
 
     m_simpleCoverDatabase.emplace_back(std::move(elem));
+    indexCoverElement(m_simpleCoverDatabase.size()-1);
 
     return true;
 }
 
+bool CoverDatabase::removeUid(const boost::uuids::uuid &uid) {
+    auto position = m_uidIndex.find(uid);
+    if (!position)
+        return false;
+
+    m_uidIndex.erase(uid);
+    auto& elem = m_simpleCoverDatabase[*position];
+    if (elem.removeUid(uid) && elem.isOrphan()) {
+        logger(Level::debug) << "cover <" << elem.hash << "> is not used anymore\n";
+        ++m_orphanCount;
+    }
+    return true;
+}
+
+std::size_t CoverDatabase::collectGarbage() {
+
+    if (m_orphanCount == 0)
+        return 0;
+
+    auto end = std::remove_if(std::begin(m_simpleCoverDatabase), std::end(m_simpleCoverDatabase),
+                              [](const CoverElement& elem) { return elem.isOrphan(); });
+    auto removed = static_cast<std::size_t>(std::distance(end, std::end(m_simpleCoverDatabase)));
+    m_simpleCoverDatabase.erase(end, std::end(m_simpleCoverDatabase));
+
+    // the positions have changed, so all indexes are built again
+    m_uidIndex.clear();
+    m_hashIndex.clear();
+    m_orphanCount = 0;
+    for (std::size_t position{0}; position < m_simpleCoverDatabase.size(); ++position)
+        indexCoverElement(position);
+
+    logger(Level::info) << "removed <" << removed << "> covers without reference\n";
+    return removed;
+}
+
+std::size_t CoverDatabase::removeOrphanFiles() const {
+
+    std::size_t removed {0};
+    for (const auto& file : Common::FileSystemAdditions::getAllFilesInDir(Common::FileType::Cache)) {
+        if (file.extension != ".cache")
+            continue;
+        try {
+            if (m_hashIndex.count(boost::lexical_cast<std::size_t>(file.name)) > 0)
+                continue;
+        } catch (boost::bad_lexical_cast&) {
+            // not a cover file
+            continue;
+        }
+        boost::system::error_code ec;
+        if (boost::filesystem::remove(Common::FileSystemAdditions::getFullName(file), ec)) {
+            logger(Level::debug) << "removed cover file <" << file.name << file.extension << ">\n";
+            ++removed;
+        }
+        else if (ec) {
+            logger(Level::warning) << "cannot remove cover file <" << file.name << file.extension << ">: " << ec.message() << "\n";
+        }
+    }
+
+    return removed;
+}
+
 bool CoverDatabase::readCache(const std::string &coverCacheFile)
 {
     // read image cache information
@@ -810,12 +1459,15 @@ bool CoverDatabase::readCache(const std::string &coverCacheFile)
                 ofs.seekg(0, std::ios::beg);
 
                 // reserve capacity
-                elem.rawData.reserve(static_cast<std::vector<uint8_t>::size_type>(fileSize));
-                elem.rawData.insert(elem.rawData.begin(),
-                                    std::istream_iterator<uint8_t>(ofs),
-                                    std::istream_iterator<uint8_t>());
+                std::vector<char> rawData;
+                rawData.reserve(static_cast<std::vector<uint8_t>::size_type>(fileSize));
+                rawData.insert(rawData.begin(),
+                               std::istream_iterator<uint8_t>(ofs),
+                               std::istream_iterator<uint8_t>());
+                elem.rawData = std::make_shared<const std::vector<char>>(std::move(rawData));
 
                 m_simpleCoverDatabase.emplace_back(std::move(elem));
+                indexCoverElement(m_simpleCoverDatabase.size()-1);
 
             }
             else {
@@ -839,7 +1491,8 @@ bool CoverDatabase::writeCache(const std::string &coverCacheFile) {
     uint64_t entryCounter {0};
     std::for_each(std::begin(m_simpleCoverDatabase), std::end(m_simpleCoverDatabase),
                   [&entryCounter](const auto& elem) { entryCounter += elem.uidListForCover.size(); } );
-    logger(Level::info) << "medial number of items with same cover: " << entryCounter/m_simpleCoverDatabase.size() << "\n";
+    if (!m_simpleCoverDatabase.empty())
+        logger(Level::info) << "medial number of items with same cover: " << entryCounter/m_simpleCoverDatabase.size() << "\n";
     auto jsonCover = coverToJson(m_simpleCoverDatabase);
     if (jsonCover)
         writeJson(std::move(*jsonCover), coverCacheFile);
@@ -854,8 +1507,8 @@ bool CoverDatabase::writeCache(const std::string &coverCacheFile) {
             logger(Level::debug) << "creating file: " << filename <<"\n";
             std::ofstream ofs(filename.c_str(), std::ios::binary);
             if (ofs.good()) {
-                for(const auto& val : elem.rawData)
-                    ofs << val;
+                if (elem.hasImage())
+                    ofs.write(elem.rawData->data(), static_cast<std::streamsize>(elem.rawData->size()));
             }
             else {
                 logger(Level::warning) << "cannot create file <"<<filename<<">\n";
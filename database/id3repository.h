@@ -2,7 +2,10 @@
 #define ID3REPOSITORY_H
 
 #include <vector>
+#include <tuple>
+#include <memory>
 #include <algorithm>
+#include <unordered_map>
 #include <boost/uuid/uuid.hpp>
 
 #include "searchitem.h"
@@ -16,6 +19,16 @@
 #include "nlohmann/json.hpp"
 #include "songtagreader.h"
 #include "common/hash.h"
+#include "uuidindex.h"
+#include "trigramindex.h"
+#include "textcolumn.h"
+#include "completionindex.h"
+#include "libraryfacets.h"
+#include "changelog.h"
+#include "indexfile.h"
+#include "query.h"
+#include "resultlist.h"
+#include "resultpage.h"
 
 using namespace LoggerFramework;
 
@@ -27,14 +40,30 @@ enum class AddType {
     json
 };
 
+enum class DuplicateKey {
+    tags,       //< same (normalized) title, album and performer
+    content     //< local audio files with the same content (size, hash and bytes compared)
+};
+
+// memory for the temporary data of a bulk load (e.g. the parsed cache files)
+enum class LoadAllocator {
+    heap,       //< single heap allocations
+    arena       //< one arena per file, released as a whole
+};
+
 struct CoverElement {
-    std::vector<boost::uuids::uuid> uidListForCover; //< list of uuid of songs with the same cover (identified by hash)
-    std::vector<char> rawData; //< raw image binary
+    std::vector<boost::uuids::uuid> uidListForCover; //< list of uuid of songs with the same cover (identified by hash), the references of the cover
+    std::shared_ptr<const std::vector<char>> rawData; //< raw image binary, shared by all versions of the database
     std::size_t hash {0}; //< hash value for the cover image
 
     CoverElement() = default;
 
     bool isConnectedToUid(const boost::uuids::uuid& uid) const;
+    bool removeUid(const boost::uuids::uuid& uid);
+
+    bool hasImage() const { return rawData && !rawData->empty(); }
+    // no song (or playlist) refers to this cover anymore
+    bool isOrphan() const { return uidListForCover.empty(); }
 
     bool hasEqualHash(const std::size_t otherHash) { return hash == otherHash; }
 
@@ -49,17 +78,27 @@ bool writeJson(nlohmann::json &&data, const std::string &filename);
 class CoverDatabase {
 
     std::vector<CoverElement> m_simpleCoverDatabase;
+    UuidIndex m_uidIndex; //< audio uid -> position of the cover element in m_simpleCoverDatabase
+    std::unordered_map<std::size_t, std::size_t> m_hashIndex; //< cover hash -> position in m_simpleCoverDatabase
+    std::size_t m_orphanCount {0}; //< cover elements without any reference
+
+    void indexCoverElement(std::size_t position);
 
 public:
     bool addCover(std::vector<char>&& rawData, const boost::uuids::uuid& _uid);
+    // drops the reference of the uid, a cover without references stays until the next garbage collection
+    bool removeUid(const boost::uuids::uuid& uid);
 
-    std::optional<std::reference_wrapper<const CoverElement>> getCover(const boost::uuids::uuid& uid) const {
+    std::size_t orphanCount() const { return m_orphanCount; }
+    // removes all covers without references from memory, returns the number of removed covers
+    std::size_t collectGarbage();
+    // removes the image files of the cache directory, that belong to no cover of the database
+    std::size_t removeOrphanFiles() const;
 
-        const auto it = std::find_if(std::cbegin(m_simpleCoverDatabase), std::cend(m_simpleCoverDatabase),
-                            [&uid](const CoverElement& elem) { return elem.isConnectedToUid(uid); } );
+    std::optional<std::reference_wrapper<const CoverElement>> getCover(const boost::uuids::uuid& uid) const {
 
-        if (it != std::cend(m_simpleCoverDatabase)) {
-            return *it;
+        if (auto position = m_uidIndex.find(uid)) {
+            return m_simpleCoverDatabase[*position];
         }
 
         return std::nullopt;
@@ -75,6 +114,31 @@ public:
 class Id3Repository
 {
     std::vector<Id3Info> m_simpleDatabase;
+    UuidIndex m_uidIndex; //< audio uid -> position in m_simpleDatabase
+    TrigramIndex m_titleIndex; //< substring index on the normalized title
+    TrigramIndex m_albumIndex; //< substring index on the normalized album name
+    TrigramIndex m_performerIndex; //< substring index on the normalized performer name
+    // album playlist uid and normalized title -> position in m_simpleDatabase (items of album playlists only)
+    std::unordered_multimap<std::string, uint32_t> m_albumTitleIndex;
+    // columnar copies of the normalized fields for the brute force scan, rebuilt on demand after changes
+    mutable TextColumn m_titleColumn;
+    mutable TextColumn m_albumColumn;
+    mutable TextColumn m_performerColumn;
+    mutable bool m_columnsDirty { false };
+    // words of all normalized fields for the prefix completion, rebuilt on demand after changes
+    mutable CompletionIndex m_completionIndex;
+    mutable bool m_completionDirty { true };
+    // track counts per performer, album and tag, kept up to date with every change
+    LibraryFacets m_facets;
+    // browse orders (rows sorted by title, performer and time of adding), rebuilt on demand after changes
+    mutable std::vector<uint32_t> m_titleOrder;
+    mutable std::vector<uint32_t> m_performerOrder;
+    mutable std::vector<uint32_t> m_addedOrder;
+    mutable bool m_ordersDirty { true };
+    std::vector<uint64_t> m_addedSequence; //< number of adding for every row
+    uint64_t m_nextSequence { 0 };
+    uint64_t m_generation { 0 }; //< increased with every change of the audio items
+    ChangeLog m_changeLog; //< latest added, removed and modified audio items
     CoverDatabase m_simpleCoverDatabase;
 
     id3TagReader m_tagReader;
@@ -86,7 +150,6 @@ class Id3Repository
 
     std::optional<nlohmann::json> id3ToJson(const std::vector<Id3Info>::const_iterator& begin, const std::vector<Id3Info>::const_iterator& end) const;
     std::optional<nlohmann::json> id3ToJson(const std::vector<Id3Info>& id3Db) const;
-    const std::vector<Id3Info> id3fromJson(const std::string& file) const ;
 //    std::optional<nlohmann::json> coverToJson(const std::vector<CoverElement>& coverDb) const;
 //    const std::vector<CoverElement> coverFromJson(const std::string& filename) const;
 
@@ -97,10 +160,37 @@ class Id3Repository
 
     bool readCache();
     bool writeCacheInternal();
+    bool writeCoverCache();
 
     bool isCached(const std::string& url) const;
 
-    std::vector<Id3Info> upn(std::vector<std::string>& whatlist, SearchItem item);
+    void logStringPoolUsage() const;
+
+    // leaf predicates of the query engine
+    QueryBitSet matchAlike(const std::string& what, SearchItem item) const;
+    QueryBitSet matchExact(const std::string& what, SearchItem item) const;
+    QueryBitSet scanAlike(const std::vector<std::string>& whatList, SearchItem item) const;
+    // sets the rows with a tag alike any of the words
+    void matchTags(const std::vector<std::string>& whatList, QueryBitSet& result) const;
+    void refreshColumns() const;
+    void refreshCompletion() const;
+    void refreshOrders() const;
+
+    // checksum of everything the search indexes depend on, ties the index file to the cache
+    uint64_t contentChecksum() const;
+    bool restoreSearchIndexes(const IndexFile::Reader& reader);
+    bool restoreOrders(const IndexFile::Reader& reader);
+    bool writeSearchIndexes(const std::string& filename) const;
+    const std::vector<uint32_t>& order(SortOrder sortOrder) const;
+    int relevance(std::size_t row, const std::vector<std::string>& whatList) const;
+    ResultList<Id3Info> paginate(const ResultList<Id3Info>& findData, const std::vector<std::string>& whatList, const PageRequest& page) const;
+    ResultList<Id3Info> collect(const QueryBitSet& result) const;
+
+    static std::string albumTitleKey(const boost::uuids::uuid& albumUid, std::string_view normalizedTitle);
+    // the uid and substring indexes are left out, if they are taken from the index file
+    void indexEntry(std::size_t position, bool withSearchIndexes = true);
+    void unindexEntry(std::size_t position);
+    std::optional<QueryBitSet> searchAlikeIndexed(const std::vector<std::string>& whatList, SearchItem item) const;
 
 public:
 
@@ -113,21 +203,76 @@ public:
     bool addCover(boost::uuids::uuid&& uuid, std::vector<char>&& data);
     bool remove(const boost::uuids::uuid& uuid);
 
+    // covers without references are kept until they are collected
+    std::size_t orphanCoverCount() const { return m_simpleCoverDatabase.orphanCount(); }
+    // removes the covers without references from memory and the cache, returns the number of removed covers
+    std::size_t collectCoverGarbage();
+    // removes the cover files of the cache directory, that are not used anymore
+    std::size_t removeOrphanCoverFiles() const;
+
     void addTags(const SongTagReader& songTagReader);
 
+    // number of changes so far, results built for an older generation are outdated
+    uint64_t generation() const { return m_generation; }
+    const ChangeLog& changeLog() const { return m_changeLog; }
+    // the generations are taken from the sequence of this log (one sequence for the whole database)
+    void shareGenerationSequence(const ChangeLog& changeLog) { m_changeLog.shareSequence(changeLog); }
+    // build the search columns, completion words and browse orders now, a sealed repository is not changed by const access
+    void seal() const { refreshColumns(); refreshCompletion(); refreshOrders(); }
+
     void clear();
 
-    std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> findDuplicates();
+    // one entry per group of duplicates: the first audio item and the uids of all further ones
+    std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>> findDuplicates(DuplicateKey key = DuplicateKey::tags) const;
+
+    // the find methods return handles into the repository, the search methods copies
+    ResultList<Id3Info> find(const boost::uuids::uuid &what, SearchItem item,
+                             SearchAction action = SearchAction::exact) const;
+
+    ResultList<Id3Info> find(const std::string &what, SearchItem item,
+                             SearchAction action = SearchAction::exact) const;
+
+    // all criteria must match (e.g. album and performer)
+    ResultList<Id3Info> find(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList,
+                             SearchAction action = SearchAction::exact) const;
+
+    // one page of the result in the requested order
+    ResultList<Id3Info> find(const std::string &what, SearchItem item,
+                             SearchAction action, const PageRequest& page) const;
+
+    ResultList<Id3Info> find(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList,
+                             SearchAction action, const PageRequest& page) const;
 
     std::vector<Id3Info> search(const boost::uuids::uuid &what, SearchItem item,
-                                               SearchAction action = SearchAction::exact);
+                                               SearchAction action = SearchAction::exact) const;
 
     std::vector<Id3Info> search(const std::string &what, SearchItem item,
-                                               SearchAction action = SearchAction::exact);
+                                               SearchAction action = SearchAction::exact) const;
+
+    std::vector<Id3Info> search(const std::vector<std::tuple<SearchItem, std::string>>& criteriaList,
+                                               SearchAction action = SearchAction::exact) const;
+
+    // exact match of a single audio item, as done by find with SearchAction::exact (whatLower is normalized)
+    static bool matchesExact(const Id3Info& info, const std::string& whatLower, SearchItem item);
+
+    // words of titles, albums and performers starting with the (normalized) prefix, most frequent first
+    std::vector<std::string> complete(const std::string& prefix, CompletionIndex::State& state,
+                                      std::size_t limit = CompletionIndex::defaultLimit) const;
+
+    std::vector<Common::AlbumListEntry> extractAlbumList() const;
+
+    const LibraryFacets& facets() const { return m_facets; }
 
-    std::vector<Common::AlbumListEntry> extractAlbumList();
+    // audio items of a cache file
+    static std::vector<Id3Info> id3fromJson(const std::string& file, LoadAllocator allocator = LoadAllocator::arena);
 
     std::optional<Id3Info> getId3InfoByUid(const boost::uuids::uuid& uid) const;
+    // handle into the repository, nullptr if not found
+    const Id3Info* findByUid(const boost::uuids::uuid& uid) const;
+    // handles of all uuids found in list order (e.g. the items of a playlist), unknown uuids are skipped
+    ResultList<Id3Info> findByUidList(const std::vector<boost::uuids::uuid>& uidList) const;
+    // handles of the items of an album playlist with this title (compared normalized)
+    ResultList<Id3Info> findByAlbumTitle(const boost::uuids::uuid& albumUid, const std::string& title) const;
 
     bool utf8_check_is_valid(const std::string& string) const;
 
@@ -135,7 +280,7 @@ public:
     bool writeCache();
 
 #ifdef WITH_UNITTEST
-    bool add(Id3Info&& info) { m_simpleDatabase.emplace_back(info); return true; }
+    bool add(Id3Info&& info) { m_simpleDatabase.emplace_back(info); indexEntry(m_simpleDatabase.size()-1); return true; }
 #endif
 };
 
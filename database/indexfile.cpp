@@ -0,0 +1,157 @@
+#include "indexfile.h"
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include "common/hash.h"
+#include "common/logger.h"
+
+using namespace Database::IndexFile;
+using namespace LoggerFramework;
+
+namespace {
+
+constexpr char fileMagic[8] { 'A', 'S', 'I', 'N', 'D', 'E', 'X', '\0' };
+constexpr uint32_t byteOrderMark { 0x01020304 };
+constexpr std::size_t sectionAlignment { 8 };
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t contentChecksum;
+    uint64_t dataChecksum;      //< of everything behind the file header
+    uint32_t sectionCount;
+    uint32_t reserved;
+};
+
+struct SectionHeader {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;            //< from the start of the file
+    uint64_t size;              //< in bytes
+};
+
+std::size_t align(std::size_t offset) {
+    return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
+
+}
+
+bool Writer::write(const std::string &filename, uint64_t contentChecksum) const {
+
+    // lay out the sections behind the section table
+    std::vector<SectionHeader> sectionTable;
+    std::size_t offset { align(sizeof(FileHeader) + m_sectionList.size() * sizeof(SectionHeader)) };
+    for (const auto& section : m_sectionList) {
+        sectionTable.push_back({ section.id, section.elementSize, offset, section.data.size() });
+        offset = align(offset + section.data.size());
+    }
+
+    std::vector<char> fileData(offset, 0);
+    std::memcpy(fileData.data() + sizeof(FileHeader), sectionTable.data(), sectionTable.size() * sizeof(SectionHeader));
+    for (std::size_t i{0}; i < m_sectionList.size(); ++i) {
+        if (!m_sectionList[i].data.empty())
+            std::memcpy(fileData.data() + sectionTable[i].offset, m_sectionList[i].data.data(), m_sectionList[i].data.size());
+    }
+
+    FileHeader header {};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    header.contentChecksum = contentChecksum;
+    header.dataChecksum = Common::genHash64(fileData.data() + sizeof(FileHeader), fileData.size() - sizeof(FileHeader));
+    header.sectionCount = static_cast<uint32_t>(m_sectionList.size());
+    std::memcpy(fileData.data(), &header, sizeof(header));
+
+    auto tmpFilename = filename + ".tmp";
+    {
+        std::ofstream ofs(tmpFilename, std::ios::binary | std::ios::trunc);
+        if (!ofs.good()) {
+            logger(Level::warning) << "cannot create index file <" << tmpFilename << ">\n";
+            return false;
+        }
+        ofs.write(fileData.data(), static_cast<std::streamsize>(fileData.size()));
+        if (!ofs.good()) {
+            logger(Level::warning) << "cannot write index file <" << tmpFilename << ">\n";
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpFilename, filename, ec);
+    if (ec) {
+        logger(Level::warning) << "cannot replace index file <" << filename << ">: " << ec.message() << "\n";
+        return false;
+    }
+
+    logger(Level::info) << "index file <" << filename << "> written with <" << m_sectionList.size() << "> sections\n";
+    return true;
+}
+
+std::optional<Reader> Reader::open(const std::string &filename, uint64_t contentChecksum) {
+
+    if (!boost::filesystem::exists(filename))
+        return std::nullopt;
+
+    Reader reader;
+    try {
+        reader.m_file = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+        reader.m_region = boost::interprocess::mapped_region(reader.m_file, boost::interprocess::read_only);
+    } catch (std::exception& ex) {
+        logger(Level::warning) << "cannot map index file <" << filename << ">: " << ex.what() << "\n";
+        return std::nullopt;
+    }
+
+    auto data = static_cast<const char*>(reader.m_region.get_address());
+    auto size = reader.m_region.get_size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        logger(Level::warning) << "index file <" << filename << "> is too short\n";
+        return std::nullopt;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+            header.version != version || header.byteOrder != byteOrderMark) {
+        logger(Level::info) << "index file <" << filename << "> has another format\n";
+        return std::nullopt;
+    }
+
+    if (header.contentChecksum != contentChecksum) {
+        logger(Level::info) << "index file <" << filename << "> does not fit the cache\n";
+        return std::nullopt;
+    }
+
+    if (size < sizeof(FileHeader) + header.sectionCount * sizeof(SectionHeader) ||
+            header.dataChecksum != Common::genHash64(data + sizeof(FileHeader), size - sizeof(FileHeader))) {
+        logger(Level::warning) << "index file <" << filename << "> is damaged\n";
+        return std::nullopt;
+    }
+
+    return reader;
+}
+
+std::optional<std::pair<const char*, std::size_t>> Reader::find(uint32_t id, uint32_t elementSize) const {
+
+    auto data = static_cast<const char*>(m_region.get_address());
+    auto size = m_region.get_size();
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    for (uint32_t i{0}; i < header.sectionCount; ++i) {
+        SectionHeader section;
+        std::memcpy(&section, data + sizeof(FileHeader) + i * sizeof(SectionHeader), sizeof(section));
+        if (section.id != id)
+            continue;
+        if (section.elementSize != elementSize || section.offset % sectionAlignment != 0 ||
+                section.offset > size || section.size > size - section.offset || section.size % elementSize != 0) {
+            logger(Level::warning) << "index file section <" << id << "> is invalid\n";
+            return std::nullopt;
+        }
+        return std::make_pair(data + section.offset, static_cast<std::size_t>(section.size));
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,93 @@
+#ifndef DATABASE_INDEXFILE_H
+#define DATABASE_INDEXFILE_H
+
+#include <vector>
+#include <string>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Database {
+
+/*!
+ * \brief IndexFile stores flat arrays (sections) of an index next to the cache, so they
+ * are not rebuilt at every start.
+ * The file begins with a versioned header and a table of sections, that are found by
+ * their offset from the start of the file, so the file is read through a memory mapping
+ * without any parsing. The header holds a checksum of the content the index was built
+ * for (e.g. the audio items of the cache) and one of the sections. A file, that does not
+ * fit the current content, is not used at all.
+ * The data is written in host byte order, a file of another machine is rejected.
+ */
+namespace IndexFile {
+
+static constexpr uint32_t version { 1 };
+
+template <typename T>
+struct ArrayView {
+    const T* data { nullptr };
+    std::size_t size { 0 };
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](std::size_t position) const { return data[position]; }
+};
+
+class Writer {
+
+    struct Section {
+        uint32_t id;
+        uint32_t elementSize;
+        std::vector<char> data;
+    };
+
+    std::vector<Section> m_sectionList;
+
+public:
+
+    template <typename T>
+    void add(uint32_t id, const T* data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "only flat data can be written to an index file");
+        Section section { id, static_cast<uint32_t>(sizeof(T)), std::vector<char>(count * sizeof(T)) };
+        if (count > 0)
+            std::memcpy(section.data.data(), data, count * sizeof(T));
+        m_sectionList.push_back(std::move(section));
+    }
+
+    template <typename T>
+    void add(uint32_t id, const std::vector<T>& data) { add(id, data.data(), data.size()); }
+
+    // written to a temporary file first, that replaces the old one when complete
+    bool write(const std::string& filename, uint64_t contentChecksum) const;
+
+};
+
+class Reader {
+
+    boost::interprocess::file_mapping m_file;
+    boost::interprocess::mapped_region m_region;
+
+    std::optional<std::pair<const char*, std::size_t>> find(uint32_t id, uint32_t elementSize) const;
+
+public:
+
+    // nullopt if the file does not exist or does not fit the content (or this version)
+    static std::optional<Reader> open(const std::string& filename, uint64_t contentChecksum);
+
+    template <typename T>
+    std::optional<ArrayView<T>> section(uint32_t id) const {
+        if (auto section = find(id, sizeof(T)))
+            return ArrayView<T> { reinterpret_cast<const T*>(section->first), section->second / sizeof(T) };
+        return std::nullopt;
+    }
+
+};
+
+}
+
+}
+
+#endif // DATABASE_INDEXFILE_H
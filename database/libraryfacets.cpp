@@ -0,0 +1,73 @@
+#include "libraryfacets.h"
+
+#include <algorithm>
+
+using namespace Database;
+
+void LibraryFacets::add(CounterMap &counterMap, const std::string &key, const std::string &name, const std::string &group) {
+    if (key.empty())
+        return;
+
+    auto& counter = counterMap[key];
+    if (counter.trackCount == 0)
+        counter.name = name;
+    ++counter.trackCount;
+    if (!group.empty())
+        ++counter.groupTracks[group];
+}
+
+void LibraryFacets::remove(CounterMap &counterMap, const std::string &key, const std::string &group) {
+    auto it = counterMap.find(key);
+    if (it == std::end(counterMap))
+        return;
+
+    auto& counter = it->second;
+    if (--counter.trackCount == 0) {
+        counterMap.erase(it);
+        return;
+    }
+
+    auto groupIt = counter.groupTracks.find(group);
+    if (groupIt != std::end(counter.groupTracks) && --groupIt->second == 0)
+        counter.groupTracks.erase(groupIt);
+}
+
+std::vector<LibraryFacets::Entry> LibraryFacets::entries(const CounterMap &counterMap) {
+
+    std::vector<std::pair<const std::string*, Entry>> sortList;
+    sortList.reserve(counterMap.size());
+    for (const auto& [key, counter] : counterMap)
+        sortList.push_back({ &key, { counter.name, counter.trackCount, static_cast<uint32_t>(counter.groupTracks.size()) } });
+
+    std::sort(std::begin(sortList), std::end(sortList),
+              [](const auto& entry1, const auto& entry2) { return *entry1.first < *entry2.first; });
+
+    std::vector<Entry> entryList;
+    entryList.reserve(sortList.size());
+    for (auto& entry : sortList)
+        entryList.push_back(std::move(entry.second));
+
+    return entryList;
+}
+
+void LibraryFacets::add(const Id3Info &info) {
+    add(m_performers, info.getNormalizedPerformer(), info.performer_name.str(), info.getNormalizedAlbum());
+    add(m_albums, info.getNormalizedAlbum(), info.album_name.str(), info.getNormalizedPerformer());
+    for (const auto& tag : info.getTags()) {
+        auto tagName = TagConverter::getTagName(tag);
+        add(m_tags, tagName, tagName, info.getNormalizedAlbum());
+    }
+}
+
+void LibraryFacets::remove(const Id3Info &info) {
+    remove(m_performers, info.getNormalizedPerformer(), info.getNormalizedAlbum());
+    remove(m_albums, info.getNormalizedAlbum(), info.getNormalizedPerformer());
+    for (const auto& tag : info.getTags())
+        remove(m_tags, TagConverter::getTagName(tag), info.getNormalizedAlbum());
+}
+
+void LibraryFacets::clear() {
+    m_performers.clear();
+    m_albums.clear();
+    m_tags.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef DATABASE_LIBRARYFACETS_H
+#define DATABASE_LIBRARYFACETS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "id3tagreader/Id3Info.h"
+
+namespace Database {
+
+/*!
+ * \brief LibraryFacets counts the audio items per performer, album and tag. The counts
+ * are kept up to date with every audio item added to or removed from the repository,
+ * so browsing views get them without searching the whole library.
+ * Performers and albums are grouped by their normalized name, the name given is the
+ * spelling of the first audio item found.
+ */
+class LibraryFacets {
+
+public:
+    // one value of a facet with the number of its audio items
+    struct Entry {
+        std::string name;
+        uint32_t trackCount {0};
+        uint32_t groupCount {0}; //< albums of a performer or tag, performers of an album
+    };
+
+private:
+    struct Counter {
+        std::string name;
+        uint32_t trackCount {0};
+        std::unordered_map<std::string, uint32_t> groupTracks; //< normalized group name -> number of audio items
+    };
+
+    // normalized name -> counter
+    using CounterMap = std::unordered_map<std::string, Counter>;
+
+    CounterMap m_performers;
+    CounterMap m_albums;
+    CounterMap m_tags;
+
+    static void add(CounterMap& counterMap, const std::string& key, const std::string& name, const std::string& group);
+    static void remove(CounterMap& counterMap, const std::string& key, const std::string& group);
+    // sorted by the normalized name
+    static std::vector<Entry> entries(const CounterMap& counterMap);
+
+public:
+
+    void add(const Id3Info& info);
+    void remove(const Id3Info& info);
+    void clear();
+
+    std::vector<Entry> performers() const { return entries(m_performers); }
+    std::vector<Entry> albums() const { return entries(m_albums); }
+    std::vector<Entry> tags() const { return entries(m_tags); }
+
+};
+
+}
+
+#endif // DATABASE_LIBRARYFACETS_H
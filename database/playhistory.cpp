@@ -0,0 +1,209 @@
+#include "playhistory.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <boost/filesystem.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include "common/filesystemadditions.h"
+#include "common/logger.h"
+
+using namespace Database;
+using namespace LoggerFramework;
+
+namespace {
+
+constexpr char fileMagic[8] { 'A', 'S', 'P', 'L', 'A', 'Y', 'S', '\0' };
+constexpr uint32_t fileVersion { 1 };
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        auto written = ::write(fd, data, size);
+        if (written < 0)
+            return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+}
+
+PlayHistory::PlayHistory(std::string filename, std::size_t bufferCapacity)
+    : m_filename(std::move(filename)), m_bufferCapacity(std::max<std::size_t>(bufferCapacity, 1)) {
+    m_buffer.reserve(m_bufferCapacity);
+}
+
+PlayHistory::~PlayHistory() {
+    flushInternal();
+}
+
+std::string PlayHistory::filename() const {
+    if (!m_filename.empty())
+        return m_filename;
+    return Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::Cache) + "/play_history.log";
+}
+
+void PlayHistory::count(const boost::uuids::uuid &uid, int64_t time) {
+
+    auto& track = m_trackList[uid];
+    if (track.playCount > 0) {
+        m_mostPlayed.erase({track.playCount, uid});
+        m_recentlyPlayed.erase(track.recent);
+    }
+
+    ++track.playCount;
+    track.lastPlayed = time;
+    m_mostPlayed.emplace(track.playCount, uid);
+    m_recentlyPlayed.push_front(uid);
+    track.recent = std::begin(m_recentlyPlayed);
+    ++m_playCount;
+}
+
+PlayHistory::Entry PlayHistory::toEntry(const boost::uuids::uuid &uid) const {
+    const auto& track = m_trackList.at(uid);
+    return { uid, track.playCount, track.lastPlayed };
+}
+
+bool PlayHistory::read() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto historyFile = filename();
+    if (!boost::filesystem::exists(historyFile)) {
+        logger(Level::info) << "no play history <" << historyFile << "> available\n";
+        return true;
+    }
+
+    std::ifstream ifs(historyFile, std::ios::binary);
+    std::vector<char> fileData((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    FileHeader header;
+    if (fileData.size() >= sizeof(header))
+        std::memcpy(&header, fileData.data(), sizeof(header));
+    if (fileData.size() < sizeof(header) || std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+            header.version != fileVersion || header.recordSize != sizeof(Record)) {
+        logger(Level::warning) << "play history <" << historyFile << "> has another format, moving it aside\n";
+        boost::system::error_code ec;
+        boost::filesystem::rename(historyFile, historyFile + ".invalid", ec);
+        return false;
+    }
+
+    auto recordCount = (fileData.size() - sizeof(header)) / sizeof(Record);
+    for (std::size_t i{0}; i < recordCount; ++i) {
+        Record record;
+        std::memcpy(&record, fileData.data() + sizeof(header) + i * sizeof(Record), sizeof(record));
+        boost::uuids::uuid uid;
+        std::memcpy(uid.data, record.uid, sizeof(record.uid));
+        count(uid, record.time);
+    }
+
+    // a record cut by a crash, the next records are appended behind the last complete one
+    auto validSize = sizeof(header) + recordCount * sizeof(Record);
+    if (fileData.size() != validSize) {
+        logger(Level::warning) << "play history <" << historyFile << "> ends with an incomplete record, cutting it\n";
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(historyFile, validSize, ec);
+    }
+
+    logger(Level::info) << "play history read with <" << recordCount << "> plays of <" << m_trackList.size() << "> items\n";
+    return true;
+}
+
+void PlayHistory::add(const boost::uuids::uuid &uid) {
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+    add(uid, now.count());
+}
+
+void PlayHistory::add(const boost::uuids::uuid &uid, int64_t time) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    count(uid, time);
+
+    Record record;
+    std::memcpy(record.uid, uid.data, sizeof(record.uid));
+    record.time = time;
+    m_buffer.push_back(record);
+
+    if (m_buffer.size() >= m_bufferCapacity)
+        flushInternal();
+}
+
+bool PlayHistory::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return flushInternal();
+}
+
+bool PlayHistory::flushInternal() {
+
+    if (m_buffer.empty())
+        return true;
+
+    auto historyFile = filename();
+    int fd = ::open(historyFile.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        logger(Level::warning) << "cannot open play history <" << historyFile << ">, <" << m_buffer.size() << "> plays are lost\n";
+        m_buffer.clear();
+        return false;
+    }
+
+    bool success { true };
+
+    struct stat fileStatus;
+    if (::fstat(fd, &fileStatus) == 0 && fileStatus.st_size == 0) {
+        FileHeader header {};
+        std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+        header.version = fileVersion;
+        header.recordSize = sizeof(Record);
+        success = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    success = success && writeAll(fd, reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(Record));
+    success = success && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (!success)
+        logger(Level::warning) << "cannot write play history <" << historyFile << ">, <" << m_buffer.size() << "> plays are lost\n";
+    else
+        logger(Level::debug) << "<" << m_buffer.size() << "> plays written to the play history\n";
+
+    m_buffer.clear();
+    return success;
+}
+
+std::vector<PlayHistory::Entry> PlayHistory::mostPlayed(std::size_t limit) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> entryList;
+    entryList.reserve(std::min(limit, m_mostPlayed.size()));
+    for (auto it = std::begin(m_mostPlayed); it != std::end(m_mostPlayed) && entryList.size() < limit; ++it)
+        entryList.push_back(toEntry(it->second));
+    return entryList;
+}
+
+std::vector<PlayHistory::Entry> PlayHistory::recentlyPlayed(std::size_t limit) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> entryList;
+    entryList.reserve(std::min(limit, m_recentlyPlayed.size()));
+    for (auto it = std::begin(m_recentlyPlayed); it != std::end(m_recentlyPlayed) && entryList.size() < limit; ++it)
+        entryList.push_back(toEntry(*it));
+    return entryList;
+}
+
+uint64_t PlayHistory::playCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_playCount;
+}
+
+std::size_t PlayHistory::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buffer.size();
+}
@@ -0,0 +1,93 @@
+#ifndef DATABASE_PLAYHISTORY_H
+#define DATABASE_PLAYHISTORY_H
+
+#include <set>
+#include <list>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <boost/uuid/uuid.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace Database {
+
+/*!
+ * \brief PlayHistory logs every play of an audio item to an append only file and keeps
+ * the play counts and the latest plays of every item in memory.
+ * A play is a small binary record. The records are collected in a buffer of fixed size,
+ * that is appended (and synced) as a whole when it is full or flush is called, so a play
+ * does not cost a write of its own. Plays still in the buffer are lost on a crash.
+ * At start the counters are rebuilt from the file, an incomplete last record is cut off.
+ * Most and recently played items are kept sorted, the first k of them are given without
+ * any search.
+ * The player adds plays while the web server reads them, every access holds the lock.
+ */
+class PlayHistory {
+
+public:
+    struct Entry {
+        boost::uuids::uuid uid;
+        uint64_t playCount {0};
+        int64_t lastPlayed {0};     //< seconds since epoch
+    };
+
+private:
+    struct Record {
+        uint8_t uid[16];
+        int64_t time;
+    };
+
+    struct Track {
+        uint64_t playCount {0};
+        int64_t lastPlayed {0};
+        std::list<boost::uuids::uuid>::iterator recent; //< position in m_recentlyPlayed
+    };
+
+    std::string m_filename;
+    std::size_t m_bufferCapacity;
+    std::vector<Record> m_buffer;
+    std::unordered_map<boost::uuids::uuid, Track, boost::hash<boost::uuids::uuid>> m_trackList;
+    std::set<std::pair<uint64_t, boost::uuids::uuid>, std::greater<>> m_mostPlayed; //< (play count, uid), most first
+    std::list<boost::uuids::uuid> m_recentlyPlayed; //< latest first, every item once
+    uint64_t m_playCount {0};
+    mutable std::mutex m_mutex;
+
+    std::string filename() const;
+    bool flushInternal();
+    void count(const boost::uuids::uuid& uid, int64_t time);
+    Entry toEntry(const boost::uuids::uuid& uid) const;
+
+public:
+
+    static constexpr std::size_t defaultBufferCapacity { 32 };
+
+    // empty filename: play_history.log in the cache directory
+    explicit PlayHistory(std::string filename = "", std::size_t bufferCapacity = defaultBufferCapacity);
+    PlayHistory(const PlayHistory&) = delete;
+    PlayHistory& operator=(const PlayHistory&) = delete;
+    ~PlayHistory();
+
+    // rebuild the counters from the file, a file of another format is moved aside
+    bool read();
+
+    void add(const boost::uuids::uuid& uid);
+    void add(const boost::uuids::uuid& uid, int64_t time);
+
+    // append the buffered plays to the file
+    bool flush();
+
+    // at most limit entries
+    std::vector<Entry> mostPlayed(std::size_t limit) const;
+    std::vector<Entry> recentlyPlayed(std::size_t limit) const;
+
+    uint64_t playCount() const;
+    std::size_t pending() const;
+
+};
+
+}
+
+#endif // DATABASE_PLAYHISTORY_H
@@ -23,14 +23,14 @@ boost::uuids::uuid Playlist::getUniqueID() const
 void Playlist::setName(const std::string &name)
 {
     m_item.m_name = name;
-    m_item.m_name_lower = Common::str_tolower(name);
+    m_item.m_name_lower = Common::normalize(name);
     setChanged(Changed::isChanged);
 }
 
 void Playlist::setPerformer(const std::string &performer)
 {
     m_item.m_performer = performer;
-    m_item.m_performer_lower = Common::str_tolower(performer);
+    m_item.m_performer_lower = Common::normalize(performer);
     setChanged(Changed::isChanged);
 }
 
@@ -51,6 +51,13 @@ bool Playlist::addToList(boost::uuids::uuid&& audioUID) {
     return true;
 }
 
+bool Playlist::insertToList(boost::uuids::uuid&& audioUID, std::size_t position) {
+    position = std::min(position, m_playlist.size());
+    m_playlist.emplace(std::begin(m_playlist) + static_cast<std::ptrdiff_t>(position), std::move(audioUID));
+    setChanged(Changed::isChanged);
+    return true;
+}
+
 bool Playlist::delFromList(const boost::uuids::uuid &audioUID) {
     auto it = std::find_if(std::begin(m_playlist), std::end(m_playlist),
                            [&audioUID](const boost::uuids::uuid& id){ return audioUID == id; });
@@ -114,6 +121,7 @@ bool Playlist::readJson(FindAlgo&& findAlgo, std::function<void(boost::uuids::uu
 {
 
     std::vector<boost::uuids::uuid> playlist;
+    std::vector<PlaylistRule> ruleList;
     boost::uuids::uuid uid;
     std::string playlistName;
     std::string performerName;
@@ -169,18 +177,21 @@ bool Playlist::readJson(FindAlgo&& findAlgo, std::function<void(boost::uuids::uu
                 }
                 else if (elem.find(ServerConstant::JsonField::album) != elem.end()) {
                     auto audioItemList = findAlgo(elem.at(ServerConstant::JsonField::album), SearchItem::album);
+                    ruleList.push_back({SearchItem::album, Common::normalize(elem.at(ServerConstant::JsonField::album).get<std::string>())});
                     for (const auto& UuidItem : audioItemList) {
                         playlist.emplace_back(UuidItem);
                     }
                 }
                 else if (elem.find(ServerConstant::JsonField::performer) != elem.end()) {
                     auto audioItemList = findAlgo(elem.at(ServerConstant::JsonField::performer), SearchItem::performer);
+                    ruleList.push_back({SearchItem::performer, Common::normalize(elem.at(ServerConstant::JsonField::performer).get<std::string>())});
                     for (const auto& UuidItem : audioItemList) {
                         playlist.emplace_back(UuidItem);
                     }
                 }
                 else if (elem.find(ServerConstant::JsonField::title) != elem.end()) {
                     auto audioItemList = findAlgo(elem.at(ServerConstant::JsonField::title), SearchItem::title);
+                    ruleList.push_back({SearchItem::title, Common::normalize(elem.at(ServerConstant::JsonField::title).get<std::string>())});
                     for (const auto& UuidItem : audioItemList) {
                         playlist.emplace_back(UuidItem);
                     }
@@ -198,12 +209,15 @@ bool Playlist::readJson(FindAlgo&& findAlgo, std::function<void(boost::uuids::uu
     } catch (std::exception& ex) {
         logger(Level::warning) << "failed to read file: " << m_playlistFileName << ": " << ex.what() << "\n";
         playlist.clear();
+        ruleList.clear();
     }
 
-    if (playlist.size() > 0) {
+    // a smart playlist is kept, even if no audio item matches yet
+    if (playlist.size() > 0 || !ruleList.empty()) {
         logger(Level::debug) << "stream playlist: <" << uid <<"> (" << playlistName << ") <"<<playlist.size()<<"> elements read\n";
         setUniqueID(std::move(uid));        
         m_playlist = std::move(playlist);
+        m_ruleList = std::move(ruleList);
         setName(std::move(playlistName));
         setPerformer(std::move(performerName));
         setTagList(tagList);
@@ -46,9 +46,16 @@ struct PlaylistItem {
     std::string m_performer;
     std::string m_performer_lower;
     std::vector<Tag> m_tagList;
+    TagMask m_tagMask {0};
 
 };
 
+// an audio item belongs to a smart playlist, if it matches one of its rules exactly
+struct PlaylistRule {
+    SearchItem m_item;
+    std::string m_what; //< normalized
+};
+
 typedef std::function<std::vector<boost::uuids::uuid>(const std::string& what, SearchItem searchItem)> FindAlgo;
 typedef std::function<void(boost::uuids::uuid&& uid, std::vector<char>&& data)> InsertCover;
 
@@ -56,16 +63,14 @@ class Playlist {
     std::string m_playlistFileName;
     PlaylistItem m_item;
     std::vector<boost::uuids::uuid> m_playlist;
+    std::vector<PlaylistRule> m_ruleList; //< album, performer and title items of a json playlist
     std::string m_coverName;
     Changed m_changed { Changed::isUnchanged };
     Persistent m_persistent { Persistent::isPermanent };
     ReadType m_readType { ReadType::isM3u };
 
-    bool findInTagList(Tag tagElement) {
-        return std::find_if(std::begin(m_item.m_tagList),
-                         std::end(m_item.m_tagList),
-                         [&tagElement](const Tag& tag){ return tag == tagElement; })
-                != std::end(m_item.m_tagList);
+    bool findInTagList(Tag tagElement) const {
+        return (m_item.m_tagMask & TagConverter::getTagMask(tagElement)) != 0;
     }
 public:
 
@@ -91,26 +96,22 @@ public:
 
     void setName(const std::string& name);
     void setPerformer(const std::string& performer);
-    void setTagList(std::vector<Tag> tagList) {
+    void setTagList(const std::vector<Tag>& tagList) {
         for (const auto& elem : tagList) {
-            if (!findInTagList(elem)) {
+            if (elem != Tag::unknown && !findInTagList(elem)) {
                 m_item.m_tagList.push_back(elem);
+                m_item.m_tagMask |= TagConverter::getTagMask(elem);
             }
         }
     }
 
     bool isTagAlike(const std::vector<std::string>& whatList ) const {
-        if (whatList.size() > 0) {
-            for (const auto& elem : whatList) {
-                for (const auto& tag : m_item.m_tagList) {
-                    if (TagConverter::getTagIdAlike(elem) == tag) {
-                        return true;
-                    }
-                }
+        return hasAnyTag(TagConverter::getTagMaskAlike(whatList));
+    }
 
-            }
-        }
-        return false;
+    // mask resolved from the request by TagConverter::getTagMaskAlike
+    bool hasAnyTag(TagMask mask) const {
+        return (m_item.m_tagMask & mask) != 0;
     }
 
     std::string strTag() const {
@@ -124,14 +125,19 @@ public:
     std::string getName() const;
     std::string getPerformer() const { return m_item.m_performer; }
 
-    std::string getNameLower() const { return m_item.m_name_lower; }
-    std::string getPerformerLower() const { return m_item.m_performer_lower; }
+    const std::string& getNameLower() const { return m_item.m_name_lower; }
+    const std::string& getPerformerLower() const { return m_item.m_performer_lower; }
 
     const std::vector<boost::uuids::uuid>& getUniqueAudioIdsPlaylist() const;
     bool addToList(boost::uuids::uuid&& audioUID);
+    bool insertToList(boost::uuids::uuid&& audioUID, std::size_t position);
     bool delFromList(const boost::uuids::uuid& audioUID);
     std::vector<boost::uuids::uuid> getPlaylist();
 
+    // the playlist is kept up to date with the audio items matching these rules
+    const std::vector<PlaylistRule>& getRuleList() const { return m_ruleList; }
+    bool isSmart() const { return !m_ruleList.empty(); }
+
     bool readM3u();
     bool readJson(FindAlgo&& findAlgo, InsertCover&& insertCover);
     bool insertAlbumList();
@@ -3,9 +3,8 @@
 #include <boost/filesystem.hpp>
 #include <functional>
 #include <boost/uuid/uuid_io.hpp>
-#include <stack>
-#include <variant>
 #include <exception>
+#include <iterator>
 
 #include "common/filesystemadditions.h"
 #include "common/logger.h"
@@ -16,17 +15,84 @@ using namespace Database;
 using namespace Common;
 using namespace LoggerFramework;
 
+Playlist* PlaylistContainer::findByUid(const boost::uuids::uuid &uid) {
+    if (auto position = m_uidIndex.find(uid))
+        return &m_playlists[*position];
+    return nullptr;
+}
+
+const Playlist* PlaylistContainer::findByUid(const boost::uuids::uuid &uid) const {
+    if (auto position = m_uidIndex.find(uid))
+        return &m_playlists[*position];
+    return nullptr;
+}
+
+std::optional<std::size_t> PlaylistContainer::findByName(const std::string &name) const {
+    // the lookup is on the normalized name, candidates are compared with the exact name
+    auto [begin, end] = m_nameLookup.equal_range(Common::normalize(name));
+    std::optional<std::size_t> found;
+    for (auto it = begin; it != end; ++it) {
+        if (m_playlists[it->second].getName() == name && (!found || it->second < *found))
+            found = it->second;
+    }
+    return found;
+}
+
+void PlaylistContainer::indexPlaylist(std::size_t position) {
+    const auto& playlist = m_playlists[position];
+    auto row = static_cast<TrigramIndex::RowId>(position);
+    m_uidIndex.insert(playlist.getUniqueID(), position);
+    m_nameIndex.add(row, playlist.getNameLower());
+    m_performerIndex.add(row, playlist.getPerformerLower());
+    m_nameLookup.emplace(playlist.getNameLower(), row);
+    m_ordersDirty = true;
+    m_generation = m_changeLog.next();
+
+    // a moved playlist keeps its sequence number, only new playlists get one
+    if (position == m_addedSequence.size()) {
+        m_addedSequence.push_back(m_nextSequence++);
+        m_generation = m_changeLog.record(ChangeLog::Kind::added, playlist.getUniqueID());
+    }
+}
+
+void PlaylistContainer::unindexPlaylist(std::size_t position) {
+    const auto& playlist = m_playlists[position];
+    auto row = static_cast<TrigramIndex::RowId>(position);
+    m_uidIndex.erase(playlist.getUniqueID());
+    m_nameIndex.remove(row, playlist.getNameLower());
+    m_performerIndex.remove(row, playlist.getPerformerLower());
+    auto [begin, end] = m_nameLookup.equal_range(playlist.getNameLower());
+    auto it = std::find_if(begin, end, [row](const auto& entry) { return entry.second == row; });
+    if (it != end)
+        m_nameLookup.erase(it);
+    m_ordersDirty = true;
+    m_generation = m_changeLog.next();
+}
+
+void PlaylistContainer::removeAt(std::size_t position) {
+    // move the last playlist into the gap, so only one playlist needs to be reindexed
+    auto lastPosition { m_playlists.size()-1 };
+    m_generation = m_changeLog.record(ChangeLog::Kind::removed, m_playlists[position].getUniqueID());
+    unindexPlaylist(position);
+    if (position != lastPosition) {
+        unindexPlaylist(lastPosition);
+        m_playlists[position] = std::move(m_playlists.back());
+        m_addedSequence[position] = m_addedSequence[lastPosition];
+        indexPlaylist(position);
+    }
+    m_playlists.pop_back();
+    m_addedSequence.pop_back();
+}
+
 void PlaylistContainer::addPlaylist(Playlist &&playlist) {
-    m_playlists.emplace_back(playlist);
+    m_playlists.emplace_back(std::move(playlist));
+    indexPlaylist(m_playlists.size()-1);
 }
 
 bool PlaylistContainer::addItemToPlaylistName(const std::string &playlistName, boost::uuids::uuid &&audioUniqueId) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists), [&playlistName](const Playlist& item) {
-        return item.getName() == playlistName;
-    });
-
-    if (it != std::end(m_playlists)) {
-        it->addToList(std::move(audioUniqueId));
+    if (auto position = findByName(playlistName)) {
+        m_playlists[*position].addToList(std::move(audioUniqueId));
+        m_generation = m_changeLog.record(ChangeLog::Kind::modified, m_playlists[*position].getUniqueID());
         return true;
     }
 
@@ -34,12 +100,9 @@ bool PlaylistContainer::addItemToPlaylistName(const std::string &playlistName, b
 }
 
 bool PlaylistContainer::addItemToPlaylistUID(const boost::uuids::uuid &playlistUniqueID, boost::uuids::uuid &&audioUniqueId) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists), [&playlistUniqueID](const Playlist& item) {
-        return item.getUniqueID() == playlistUniqueID;
-    });
-
-    if (it != std::end(m_playlists)) {
-        it->addToList(std::move(audioUniqueId));
+    if (auto playlist = findByUid(playlistUniqueID)) {
+        playlist->addToList(std::move(audioUniqueId));
+        m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlistUniqueID);
         return true;
     }
 
@@ -47,12 +110,8 @@ bool PlaylistContainer::addItemToPlaylistUID(const boost::uuids::uuid &playlistU
 }
 
 bool PlaylistContainer::removePlaylistUID(const boost::uuids::uuid &playlistUniqueId) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                           [&playlistUniqueId](const Playlist& pl)
-    { return (pl.getUniqueID() == playlistUniqueId); });
-
-    if (it != std::end(m_playlists) ) {
-        m_playlists.erase(it);
+    if (auto position = m_uidIndex.find(playlistUniqueId)) {
+        removeAt(*position);
         try {
             auto rmResult = FileSystemAdditions::removeFile(FileType::PlaylistM3u, boost::lexical_cast<std::string>(playlistUniqueId));
             return rmResult;
@@ -65,13 +124,9 @@ bool PlaylistContainer::removePlaylistUID(const boost::uuids::uuid &playlistUniq
 }
 
 bool PlaylistContainer::removePlaylistName(const std::string &playlistName) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                           [&playlistName](const Playlist& pl)
-    { return (pl.getName() == playlistName); });
-
-    if (it != std::end(m_playlists) ) {
-        auto playlistUniqueId { it->getUniqueID() };
-        m_playlists.erase(it);
+    if (auto position = findByName(playlistName)) {
+        auto playlistUniqueId { m_playlists[*position].getUniqueID() };
+        removeAt(*position);
         try {
             auto rmFile = FileSystemAdditions::removeFile(FileType::PlaylistM3u, boost::lexical_cast<std::string>(playlistUniqueId));
             return rmFile;
@@ -101,24 +156,18 @@ bool PlaylistContainer::writeChangedPlaylists() {
     return success;
 }
 
-std::optional<std::string> PlaylistContainer::convertName(const boost::uuids::uuid &uid) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists), [&uid] (const Playlist& playlist) {
-        return playlist.getUniqueID() == uid;
-    });
-    if (it != std::end(m_playlists))
-        return it->getName();
+std::optional<std::string> PlaylistContainer::convertName(const boost::uuids::uuid &uid) const {
+    if (auto playlist = findByUid(uid))
+        return playlist->getName();
     else
         return std::nullopt;
 
 }
 
-std::optional<boost::uuids::uuid> PlaylistContainer::convertName(const std::string &name) {
+std::optional<boost::uuids::uuid> PlaylistContainer::convertName(const std::string &name) const {
 
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists), [&name] (const Playlist& playlist) {
-        return playlist.getName() == name;
-    });
-    if (it != std::end(m_playlists))
-        return it->getUniqueID();
+    if (auto position = findByName(name))
+        return m_playlists[*position].getUniqueID();
 
     return std::nullopt;
 }
@@ -157,7 +206,7 @@ bool PlaylistContainer::readPlaylistsJson(Database::FindAlgo&& findUuidList,
         if (file.extension == ".json") {
             Playlist playlist(std::move(fileName), ReadType::isJson, Persistent::isPermanent, Changed::isConst);
             if (playlist.readJson(std::move(findUuidList), std::move(coverInsert))) {
-                m_playlists.emplace_back(playlist);
+                addPlaylist(std::move(playlist));
             }
             else
                 logger(Level::warning) << "reading file <"<<file.name+file.extension <<"> failed\n";
@@ -170,59 +219,170 @@ bool PlaylistContainer::readPlaylistsJson(Database::FindAlgo&& findUuidList,
 bool PlaylistContainer::insertAlbumPlaylists(const std::vector<AlbumListEntry> &albumList) {
 
     for(auto& elem : albumList) {
-        try {
-            auto uniqueID = boost::lexical_cast<boost::uuids::uuid>(NameGenerator::create("", "").unique_id);
-            Playlist playlist("", ReadType::isM3u, Persistent::isTemporal);
-            playlist.setName(elem.m_name);
-            playlist.setPerformer(elem.m_performer);
-            playlist.setCover(elem.m_coverUrl);
-            playlist.setUniqueID(std::move(uniqueID));
-            for(auto& uid : elem.m_playlist) {
-                auto addUid = std::get<boost::uuids::uuid>(uid);
-                playlist.addToList(std::move(addUid));
-            }
-            m_playlists.emplace_back(playlist);
-        } catch (std::exception& ex) {
-            logger(LoggerFramework::Level::warning) << ex.what() << "\n";
+        if (findByUid(elem.m_uid)) {
+            logger(Level::debug) << "album playlist <" << elem.m_name << "> already available\n";
+            continue;
         }
+        auto uniqueID = elem.m_uid;
+        Playlist playlist("", ReadType::isM3u, Persistent::isTemporal);
+        playlist.setName(elem.m_name);
+        playlist.setPerformer(elem.m_performer);
+        playlist.setCover(elem.m_coverUrl);
+        playlist.setUniqueID(std::move(uniqueID));
+        for(auto& uid : elem.m_playlist) {
+            auto addUid = std::get<boost::uuids::uuid>(uid);
+            playlist.addToList(std::move(addUid));
+        }
+        addPlaylist(std::move(playlist));
     }
 
     return true;
 }
 
+bool PlaylistContainer::addToAlbumPlaylist(const Id3Info &info, const Id3Repository &repository) {
+
+    if (!info.albumCreation)
+        return false;
+
+    auto albumUid = Common::albumPlaylistUid(info.getNormalizedAlbum());
+    auto position = m_uidIndex.find(albumUid);
+
+    if (!position) {
+        logger(Level::info) << "create album playlist <" << info.album_name << ">\n";
+        Playlist playlist("", ReadType::isM3u, Persistent::isTemporal);
+        playlist.setName(info.album_name);
+        playlist.setPerformer(info.performer_name);
+        playlist.setCover(info.urlCoverFile);
+        playlist.setUniqueID(std::move(albumUid));
+        playlist.setTagList(info.getTags());
+        auto uid = info.uid;
+        playlist.addToList(std::move(uid));
+        addPlaylist(std::move(playlist));
+        return true;
+    }
+
+    auto& playlist = m_playlists[*position];
+    m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlist.getUniqueID());
+
+    if (info.performer_name != playlist.getPerformer() && playlist.getPerformer() != "multiple performer") {
+        // the performer is part of the search index
+        unindexPlaylist(*position);
+        playlist.setPerformer("multiple performer");
+        indexPlaylist(*position);
+    }
+    // an album created from a track without a cover takes the first cover of a later track
+    if (playlist.getCover() == ServerConstant::unknownCoverUrl &&
+            !info.urlCoverFile.empty() && info.urlCoverFile != ServerConstant::unknownCoverUrl)
+        playlist.setCover(info.urlCoverFile);
+    playlist.setTagList(info.getTags());
+
+    // the album is kept in track order
+    const auto& trackList = playlist.getUniqueAudioIdsPlaylist();
+    auto albumPosition = info.getAlbumPosition();
+    auto insertIt = std::upper_bound(std::begin(trackList), std::end(trackList), albumPosition,
+                                     [&repository](uint32_t value, const boost::uuids::uuid& trackUid) {
+        auto track = repository.findByUid(trackUid);
+        return track && value < track->getAlbumPosition();
+    });
+
+    auto uid = info.uid;
+    return playlist.insertToList(std::move(uid), static_cast<std::size_t>(std::distance(std::begin(trackList), insertIt)));
+}
+
+bool PlaylistContainer::removeFromAlbumPlaylist(const Id3Info &info) {
+
+    auto position = m_uidIndex.find(Common::albumPlaylistUid(info.getNormalizedAlbum()));
+    if (!position)
+        return false;
+
+    auto& playlist = m_playlists[*position];
+    if (!playlist.delFromList(info.uid))
+        return false;
+    m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlist.getUniqueID());
+
+    if (playlist.getUniqueAudioIdsPlaylist().empty()) {
+        logger(Level::info) << "remove empty album playlist <" << playlist.getName() << ">\n";
+        if (m_currentPlaylist && *m_currentPlaylist == playlist.getUniqueID())
+            unsetCurrentPlaylist();
+        removeAt(*position);
+    }
+
+    return true;
+}
+
+std::size_t PlaylistContainer::removeItemFromPlaylists(const boost::uuids::uuid &audioUniqueId) {
+
+    std::size_t changed {0};
+    for (auto& playlist : m_playlists) {
+        // an item may be listed more than once
+        bool found {false};
+        while (playlist.delFromList(audioUniqueId))
+            found = true;
+        if (found) {
+            m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlist.getUniqueID());
+            ++changed;
+        }
+    }
+
+    return changed;
+}
+
+std::size_t PlaylistContainer::addItemToSmartPlaylists(const Id3Info &info) {
+
+    std::size_t changed {0};
+    for (auto& playlist : m_playlists) {
+        if (!playlist.isSmart())
+            continue;
+        const auto& ruleList = playlist.getRuleList();
+        if (std::none_of(std::begin(ruleList), std::end(ruleList), [&info](const PlaylistRule& rule)
+                         { return Id3Repository::matchesExact(info, rule.m_what, rule.m_item); }))
+            continue;
+        const auto& audioIdList = playlist.getUniqueAudioIdsPlaylist();
+        if (std::find(std::begin(audioIdList), std::end(audioIdList), info.uid) != std::end(audioIdList))
+            continue;
+        auto audioUniqueId = info.uid;
+        playlist.addToList(std::move(audioUniqueId));
+        playlist.setTagList(info.getTags());
+        m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlist.getUniqueID());
+        logger(Level::info) << "audio item <" << info.uid << "> added to smart playlist <" << playlist.getName() << ">\n";
+        ++changed;
+    }
+
+    return changed;
+}
+
 void PlaylistContainer::insertTagsFromItems(const Database::Id3Repository& repository) {
+    m_generation = m_changeLog.next();
     for(auto& elem : m_playlists) {
-        for (const auto& item : elem.getUniqueAudioIdsPlaylist()) {
-            if ( auto id3Info = repository.getId3InfoByUid(item)) {
-                elem.setTagList(id3Info->tags);
-            }
+        for (const auto& id3Info : repository.findByUidList(elem.getUniqueAudioIdsPlaylist())) {
+            elem.setTagList(id3Info.getTags());
         }
     }
 }
 
 void PlaylistContainer::addTags(const std::vector<Tag>& tagList, const boost::uuids::uuid& playlistID) {
-    for(auto& elem : m_playlists) {
-        if (elem.getUniqueID() == playlistID) {
-            elem.setTagList(tagList);
-        }
+    if (auto playlist = findByUid(playlistID)) {
+        playlist->setTagList(tagList);
+        m_generation = m_changeLog.record(ChangeLog::Kind::modified, playlistID);
     }
 }
 
 void PlaylistContainer::addTags(const std::vector<Tag>& tagList) {
+    m_generation = m_changeLog.next();
     for(auto& elem : m_playlists) {
         elem.setTagList(tagList);
     }
 }
 
-std::optional<std::string> PlaylistContainer::createvirtual_m3u(const boost::uuids::uuid &playlistUuid)  {
+std::optional<std::string> PlaylistContainer::createvirtual_m3u(const boost::uuids::uuid &playlistUuid) const {
 
-    if (getPlaylistByUID(playlistUuid)) {
-        auto list = getPlaylistByUID(playlistUuid)->get();
+    if (auto playlist = findByUid(playlistUuid)) {
+        const auto& list = playlist->getUniqueAudioIdsPlaylist();
         //    nlohmann::json virtualPlaylistJson;
         nlohmann::json audioList;
         // std::stringstream m3uOutput;
-        if (list.getPlaylist().size() > 0) {
-            for (const auto& elem : list.getPlaylist()) {
+        if (list.size() > 0) {
+            for (const auto& elem : list) {
                 std::stringstream id;
                 id << ServerConstant::audioPath << "/" << elem << ".mp3";
                 audioList.push_back(id.str());
@@ -238,38 +398,29 @@ std::optional<std::string> PlaylistContainer::createvirtual_m3u(const boost::uui
     return std::nullopt;
 }
 
-std::optional<std::reference_wrapper<Playlist>> PlaylistContainer::getPlaylistByName(const std::string& playlistName) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                           [playlistName](const Playlist& elem) { return elem.getName() == playlistName; });
-
-    if (it != std::end(m_playlists)) {
-        logger(Level::debug) << "playlist found with <"<<it->getUniqueAudioIdsPlaylist().size()<<"> elements\n";
-        return *it;
+const Playlist* PlaylistContainer::getPlaylistByName(const std::string& playlistName) const {
+    if (auto position = findByName(playlistName)) {
+        const auto& playlist = m_playlists[*position];
+        logger(Level::debug) << "playlist found with <"<<playlist.getUniqueAudioIdsPlaylist().size()<<"> elements\n";
+        return &playlist;
     }
-    return std::nullopt;
+    return nullptr;
 
 }
 
-std::optional<std::reference_wrapper<Playlist>> PlaylistContainer::getPlaylistByUID(const boost::uuids::uuid &uid) {
-    auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                           [uid](const Playlist& elem) {
-        return elem.getUniqueID() == uid; });
-
-    if (it != std::end(m_playlists)) {
-        logger(Level::debug) << "playlist found with <"<<it->getUniqueAudioIdsPlaylist().size()<<"> elements\n";
-        return *it;
+const Playlist* PlaylistContainer::getPlaylistByUID(const boost::uuids::uuid &uid) const {
+    if (auto playlist = findByUid(uid)) {
+        logger(Level::debug) << "playlist found with <"<<playlist->getUniqueAudioIdsPlaylist().size()<<"> elements\n";
+        return playlist;
     }
-    return std::nullopt;
+    return nullptr;
 }
 
 std::optional<const Playlist> PlaylistContainer::getCurrentPlaylist() const {
 
     if (m_currentPlaylist) {
-        auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                               [this](const Playlist& elem) { return elem.getUniqueID() == m_currentPlaylist.value(); });
-
-        if (it != std::end(m_playlists)) {
-            return *it;
+        if (auto playlist = findByUid(*m_currentPlaylist)) {
+            return *playlist;
         }
     }
     return std::nullopt;
@@ -280,11 +431,9 @@ std::optional<const boost::uuids::uuid> PlaylistContainer::getCurrentPlaylistUni
 }
 
 bool PlaylistContainer::setCurrentPlaylist(boost::uuids::uuid &&currentPlaylistUniqueId) {
-    if (std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                     [&currentPlaylistUniqueId](const Playlist& playlist) {
-                     return (playlist.getUniqueID() == currentPlaylistUniqueId);})
-            != std::end(m_playlists)) {
+    if (findByUid(currentPlaylistUniqueId)) {
         m_currentPlaylist = currentPlaylistUniqueId;
+        m_generation = m_changeLog.next();
         return true;
     }
 
@@ -292,127 +441,120 @@ bool PlaylistContainer::setCurrentPlaylist(boost::uuids::uuid &&currentPlaylistU
     return false;
 }
 
-void PlaylistContainer::unsetCurrentPlaylist() { m_currentPlaylist.reset(); }
+void PlaylistContainer::unsetCurrentPlaylist() { m_currentPlaylist.reset(); m_generation = m_changeLog.next(); }
 
-bool PlaylistContainer::isUniqueName(const std::string &name) {
-    if (std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                     [&name](const Playlist& playlist) { return playlist.getName() == name; })
-            != std::end(m_playlists)) {
-        return false;
-    }
-    return true;
+bool PlaylistContainer::isUniqueName(const std::string &name) const {
+    return !findByName(name);
 }
 
-std::vector<std::pair<std::string, boost::uuids::uuid> > PlaylistContainer::getAllPlaylists() {
+std::vector<std::pair<std::string, boost::uuids::uuid> > PlaylistContainer::getAllPlaylists() const {
     std::vector<std::pair<std::string, boost::uuids::uuid>> list;
-    for(auto& elem : m_playlists) {
+    for(const auto& elem : m_playlists) {
         list.push_back(std::make_pair(elem.getName(), elem.getUniqueID()));
     }
     return list;
 }
 
-std::vector<Playlist> PlaylistContainer::searchPlaylists(const boost::uuids::uuid &whatUid, SearchAction action) {
+ResultList<Playlist> PlaylistContainer::findPlaylists(const boost::uuids::uuid &whatUid, SearchAction ) const {
 
-    std::vector<Playlist> playlist;
-    auto playlist_it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                                    [&whatUid](const Playlist& playlist){ return playlist.getUniqueID() == whatUid; });
-    if (playlist_it != std::end(m_playlists))
-        playlist.push_back(*playlist_it);
+    ResultList<Playlist> playlist;
+    if (auto playlistItem = findByUid(whatUid))
+        playlist.push_back(*playlistItem);
 
     return playlist;
 }
 
-std::vector<Playlist> PlaylistContainer::upn_playlist(std::vector<std::string>& whatList) {
-
-    typedef std::variant<std::string, bool> upn_value;
-
-    std::vector<Playlist> retList;
-
-    if (whatList.size() < 2) {
-        return retList;
-    }
-
-    std::for_each(std::begin(m_playlists), std::end(m_playlists),
-                  [&whatList, &retList](const Playlist& info){
-
-        std::stack<upn_value> stack;
-
-        if (whatList.size() > 1) {
-
-            for (auto& it : whatList) {
-
-                if (it == "&" || it == "|") {
-
-                    if (stack.size() < 2) {
-                        //logger (Level::warning) << "evaluation failed: not enough data\n";
-                        break;
-                    }
-
-                    upn_value value1 = stack.top();
-                    stack.pop();
-
-                    upn_value value2 = stack.top();
-                    stack.pop();
+ResultList<Playlist> PlaylistContainer::findByUidList(const std::vector<boost::uuids::uuid> &uidList) const {
 
+    ResultList<Playlist> playlist;
+    playlist.reserve(uidList.size());
+    m_uidIndex.findEach(uidList, [this, &playlist](const boost::uuids::uuid&, std::optional<std::size_t> position) {
+        if (position)
+            playlist.push_back(m_playlists[*position]);
+    });
 
-                    bool evaluate1{false};
-                    bool evaluate2{false};
+    return playlist;
+}
 
+QueryBitSet PlaylistContainer::matchAlike(const std::string& what) const {
 
-                    if (const bool* tmp = std::get_if<bool>(&value1)) {
-                        evaluate1 = *tmp;
-                    }
-                    else {
-                        evaluate1 = (info.getNameLower().find(std::get<std::string>(value1)) != std::string::npos ||
-                                info.getPerformerLower().find(std::get<std::string>(value1)) != std::string::npos);
+    QueryBitSet result(m_playlists.size());
 
-                    }
+    auto isAlike = [&what](const Playlist& playlistItem) {
+        return playlistItem.getNameLower().find(what) != std::string::npos ||
+                playlistItem.getPerformerLower().find(what) != std::string::npos;
+    };
 
-                    if (const bool* tmp = std::get_if<bool>(&value2)) {
-                        evaluate2 = *tmp;
-                    }
-                    else {
-                        evaluate2 = (info.getNameLower().find(std::get<std::string>(value2)) != std::string::npos ||
-                                info.getPerformerLower().find(std::get<std::string>(value2)) != std::string::npos);
-                    }
+    if (TrigramIndex::isIndexable(what)) {
+        auto nameCandidates = m_nameIndex.candidates(what);
+        auto performerCandidates = m_performerIndex.candidates(what);
+        for (const auto& candidateList : { &*nameCandidates, &*performerCandidates }) {
+            for (const auto& row : *candidateList) {
+                if (isAlike(m_playlists[row]))
+                    result.set(row);
+            }
+        }
+    }
+    else {
+        for (std::size_t row{0}; row < m_playlists.size(); ++row) {
+            if (isAlike(m_playlists[row]))
+                result.set(row);
+        }
+    }
 
-                    if (it == "&")
-                        stack.push(evaluate1 && evaluate2);
+    matchTags({what}, result);
 
-                    if (it == "|")
-                        stack.push(evaluate1 || evaluate2);
+    return result;
+}
 
-                    // logger (Level::info) << "push: <"<< (std::get<bool>(stack.top())?"true":"false") << ">\n";
+void PlaylistContainer::matchTags(const std::vector<std::string>& whatList, QueryBitSet& result) const {
 
-                }
-                else {
-                    // logger (Level::info) << "push <"<<it<<">\n";
-                    stack.push(it);
-                }
-
-            }
+    // tags are not part of the text index, only walk through the (short) tag lists
+    auto tagMask = TagConverter::getTagMaskAlike(whatList);
+    if (tagMask == 0)
+        return;
 
-            if (stack.size() != 1) {
-                // logger(Level::warning) << "find mechanism failed (stack is " << stack.size() << "\n";
-            } else {
-                if (const bool* tmp = std::get_if<bool>(&stack.top())) {
-                    if (*tmp == true)
-                        retList.push_back(info);
-                } else {
-                    logger(Level::warning) << "find mechanism failed - no bool evaluation\n";
-                }
-            }
+    for (std::size_t row{0}; row < m_playlists.size(); ++row) {
+        if (m_playlists[row].hasAnyTag(tagMask))
+            result.set(row);
+    }
+}
 
+std::optional<std::vector<TrigramIndex::RowId>> PlaylistContainer::findAlikeCandidates(const std::vector<std::string>& whatList) const {
+
+    std::optional<std::vector<TrigramIndex::RowId>> candidateList;
+
+    // every word must be found in name or performer, so intersect the candidates of all
+    // words long enough for the index. Shorter words are verified on the candidates only.
+    for (const auto& what : whatList) {
+        if (!TrigramIndex::isIndexable(what))
+            continue;
+
+        auto nameCandidates = *m_nameIndex.candidates(what);
+        auto performerCandidates = *m_performerIndex.candidates(what);
+        std::vector<TrigramIndex::RowId> wordCandidates;
+        std::set_union(std::begin(nameCandidates), std::end(nameCandidates),
+                       std::begin(performerCandidates), std::end(performerCandidates),
+                       std::back_inserter(wordCandidates));
+
+        if (candidateList) {
+            std::vector<TrigramIndex::RowId> intersection;
+            std::set_intersection(std::begin(*candidateList), std::end(*candidateList),
+                                  std::begin(wordCandidates), std::end(wordCandidates),
+                                  std::back_inserter(intersection));
+            candidateList = std::move(intersection);
         }
-    });
+        else {
+            candidateList = std::move(wordCandidates);
+        }
+    }
 
-    return retList;
+    return candidateList;
 }
 
+ResultList<Playlist> PlaylistContainer::findPlaylists(const std::string &what, SearchAction action) const {
 
-std::vector<Playlist> PlaylistContainer::searchPlaylists(const std::string &what, SearchAction action) {
-
-    std::vector<Playlist> playlist;
+    ResultList<Playlist> playlist;
     boost::uuids::uuid whatUid;
     bool uidValid { false };
     try {
@@ -446,37 +588,50 @@ std::vector<Playlist> PlaylistContainer::searchPlaylists(const std::string &what
         }
         logger(Level::info) << "alike playlist seaching for string <" << what << "> (" << tmp.str() << ")\n";
 
-        bool is_upn {false};
-
-        std::for_each (std::begin(whatList), std::end(whatList), [&is_upn](const std::string& index){
-            if (index == "&" || index == "|")
-                is_upn = true;
-        });
+        std::optional<Query> query;
+        if (Query::isExpression(whatList)) {
+            query = Query::compile(whatList);
+            if (!query)
+                logger(Level::warning) << "invalid search expression <" << what << ">, searching for the plain words\n";
+        }
 
-        if(is_upn) {
-            playlist = upn_playlist(whatList);
+        if (query) {
+            auto result = query->evaluate(m_playlists.size(), [this](const std::string& word) { return matchAlike(word); });
+            playlist.reserve(result.count());
+            result.forEach([this, &playlist](std::size_t row) { playlist.push_back(m_playlists[row]); });
         }
         else {
 
-
-            for(auto playlistItem{std::cbegin(m_playlists)}; playlistItem != std::cend(m_playlists); ++playlistItem) {
-                bool found {true};
-                for(auto whatElem : whatList) {
-                    if (playlistItem->getNameLower().find(whatElem) == std::string::npos &&
-                            playlistItem->getPerformerLower().find(whatElem) == std::string::npos) {
-                        // logger(Level::info) << "not found <"<<whatElem <<"> in name or performer\n";
-                        found = false;
-                        break;
+            auto isAlike = [&whatList](const Playlist& playlistItem) {
+                for(const auto& whatElem : whatList) {
+                    if (playlistItem.getNameLower().find(whatElem) == std::string::npos &&
+                            playlistItem.getPerformerLower().find(whatElem) == std::string::npos) {
+                        return false;
                     }
                 }
-                if (playlistItem->isTagAlike(whatList)) {
-                    logger(Level::info) << "found tag <" << tmp.str() << "> in <" <<playlistItem->getName() <<">\n";
-                    found = true;
-                }
+                return true;
+            };
+
+            QueryBitSet result(m_playlists.size());
 
-                if (found)
-                    playlist.push_back(*playlistItem);
+            if (auto candidateList = findAlikeCandidates(whatList)) {
+                for (const auto& row : *candidateList) {
+                    if (isAlike(m_playlists[row]))
+                        result.set(row);
+                }
+            }
+            else {
+                for (std::size_t row{0}; row < m_playlists.size(); ++row) {
+                    if (isAlike(m_playlists[row]))
+                        result.set(row);
+                }
             }
+
+            matchTags(whatList, result);
+
+            // the rows are given in storage order
+            playlist.reserve(result.count());
+            result.forEach([this, &playlist](std::size_t row) { playlist.push_back(m_playlists[row]); });
         }
         break;
     }
@@ -484,10 +639,8 @@ std::vector<Playlist> PlaylistContainer::searchPlaylists(const std::string &what
         logger(Level::info) << "uid playlist seaching for string <" << what << ">\n";
 
         if (uidValid) {
-            auto playlist_it = std::find_if(std::begin(m_playlists), std::end(m_playlists),
-                                            [&whatUid](const Playlist& playlist){ return playlist.getUniqueID() == whatUid; });
-            if (playlist_it != std::end(m_playlists))
-                playlist.push_back(*playlist_it);
+            if (auto playlistItem = findByUid(whatUid))
+                playlist.push_back(*playlistItem);
         }
         break;
     }
@@ -495,3 +648,59 @@ std::vector<Playlist> PlaylistContainer::searchPlaylists(const std::string &what
     logger(Level::debug) << "searchPlaylist size <"<<playlist.size()<<">\n";
     return playlist;
 }
+
+void PlaylistContainer::refreshOrders() const {
+
+    if (!m_ordersDirty)
+        return;
+
+    m_nameOrder = buildOrder(m_playlists.size(), [this](uint32_t row1, uint32_t row2) {
+        return m_playlists[row1].getNameLower() < m_playlists[row2].getNameLower();
+    });
+    m_performerOrder = buildOrder(m_playlists.size(), [this](uint32_t row1, uint32_t row2) {
+        return std::forward_as_tuple(m_playlists[row1].getPerformerLower(), m_playlists[row1].getNameLower()) <
+                std::forward_as_tuple(m_playlists[row2].getPerformerLower(), m_playlists[row2].getNameLower());
+    });
+    m_addedOrder = buildOrder(m_playlists.size(), [this](uint32_t row1, uint32_t row2) {
+        return m_addedSequence[row1] > m_addedSequence[row2];
+    });
+
+    m_ordersDirty = false;
+}
+
+const std::vector<uint32_t>& PlaylistContainer::order(SortOrder sortOrder) const {
+    refreshOrders();
+    switch (sortOrder) {
+    case SortOrder::performer:
+        return m_performerOrder;
+    case SortOrder::added:
+        return m_addedOrder;
+    default:
+        return m_nameOrder;
+    }
+}
+
+int PlaylistContainer::relevance(std::size_t row, const std::vector<std::string>& whatList) const {
+    const auto& playlist = m_playlists[row];
+    int score {0};
+    for (const auto& what : whatList) {
+        score += Common::matchScore(playlist.getNameLower(), what);
+        score += Common::matchScore(playlist.getPerformerLower(), what);
+    }
+    return score;
+}
+
+ResultList<Playlist> PlaylistContainer::findPlaylists(const std::string &what, SearchAction action, const PageRequest &page) const {
+    auto whatList = Common::extractWhatList(what);
+    return paginate(findPlaylists(what, action), m_playlists, page,
+                    [this](SortOrder sortOrder) -> const std::vector<uint32_t>& { return order(sortOrder); },
+                    [this, &whatList](std::size_t row) { return relevance(row, whatList); });
+}
+
+std::vector<Playlist> PlaylistContainer::searchPlaylists(const std::string &what, SearchAction action) const {
+    return findPlaylists(what, action).toVector();
+}
+
+std::vector<Playlist> PlaylistContainer::searchPlaylists(const boost::uuids::uuid &whatUid, SearchAction action) const {
+    return findPlaylists(whatUid, action).toVector();
+}
@@ -8,6 +8,7 @@
 #include <cctype>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
@@ -18,18 +19,62 @@
 #include "NameType.h"
 #include "searchaction.h"
 #include "id3repository.h"
+#include "uuidindex.h"
+#include "trigramindex.h"
+#include "query.h"
+#include "resultlist.h"
+#include "resultpage.h"
+#include "changelog.h"
 
 namespace Database {
 
 class PlaylistContainer {
 
     std::vector<Playlist> m_playlists;
+    UuidIndex m_uidIndex; //< playlist uid -> position in m_playlists
+    TrigramIndex m_nameIndex; //< substring index on the normalized playlist name
+    TrigramIndex m_performerIndex; //< substring index on the normalized performer name
+    std::unordered_multimap<std::string, uint32_t> m_nameLookup; //< normalized playlist name -> position in m_playlists
     std::optional<boost::uuids::uuid> m_currentPlaylist;
-
-    std::vector<Playlist> upn_playlist(std::vector<std::string>& whatList);
+    // browse orders (rows sorted by name, performer and time of adding), rebuilt on demand after changes
+    mutable std::vector<uint32_t> m_nameOrder;
+    mutable std::vector<uint32_t> m_performerOrder;
+    mutable std::vector<uint32_t> m_addedOrder;
+    mutable bool m_ordersDirty { true };
+    std::vector<uint64_t> m_addedSequence; //< number of adding for every row
+    uint64_t m_nextSequence { 0 };
+    uint64_t m_generation { 0 }; //< increased with every change of the playlists or the current playlist
+    ChangeLog m_changeLog; //< latest added, removed and modified playlists
+
+    // leaf predicate of the query engine
+    QueryBitSet matchAlike(const std::string& what) const;
+    // sets the rows with a tag alike any of the words
+    void matchTags(const std::vector<std::string>& whatList, QueryBitSet& result) const;
+
+    Playlist* findByUid(const boost::uuids::uuid& uid);
+    const Playlist* findByUid(const boost::uuids::uuid& uid) const;
+    // first position (in storage order) of the playlist with exactly this name
+    std::optional<std::size_t> findByName(const std::string& name) const;
+    void removeAt(std::size_t position);
+
+    void indexPlaylist(std::size_t position);
+    void unindexPlaylist(std::size_t position);
+    std::optional<std::vector<TrigramIndex::RowId>> findAlikeCandidates(const std::vector<std::string>& whatList) const;
+
+    void refreshOrders() const;
+    const std::vector<uint32_t>& order(SortOrder sortOrder) const;
+    int relevance(std::size_t row, const std::vector<std::string>& whatList) const;
 
 public:
 
+    // number of changes so far, results built for an older generation are outdated
+    uint64_t generation() const { return m_generation; }
+    const ChangeLog& changeLog() const { return m_changeLog; }
+    // the generations are taken from the sequence of this log (one sequence for the whole database)
+    void shareGenerationSequence(const ChangeLog& changeLog) { m_changeLog.shareSequence(changeLog); }
+    // build the browse orders now, a sealed container is not changed by const access
+    void seal() const { refreshOrders(); }
+
     void addPlaylist(Playlist&& playlist);
     bool addItemToPlaylistName(const std::string& playlistName, boost::uuids::uuid&& audioUniqueId);
     bool addItemToPlaylistUID(const boost::uuids::uuid& playlistUniqueID, boost::uuids::uuid&& audioUniqueId);
@@ -41,15 +86,25 @@ public:
     bool readPlaylistsJson(Database::FindAlgo&& findUuidList, Database::InsertCover&& coverInsert);
     bool insertAlbumPlaylists(const std::vector<Common::AlbumListEntry>& albumList);
 
-    std::optional<std::string> createvirtual_m3u(const boost::uuids::uuid& playlistUuid);
+    // keep the album playlist of a single audio item up to date (created or removed if needed)
+    bool addToAlbumPlaylist(const Id3Info& info, const Database::Id3Repository& repository);
+    bool removeFromAlbumPlaylist(const Id3Info& info);
+    // removes a deleted audio item from all playlists, returns the number of changed playlists
+    std::size_t removeItemFromPlaylists(const boost::uuids::uuid& audioUniqueId);
+    // evaluates the rules of the smart playlists for a new audio item only and lists it where they match,
+    // returns the number of changed playlists
+    std::size_t addItemToSmartPlaylists(const Id3Info& info);
+
+    std::optional<std::string> createvirtual_m3u(const boost::uuids::uuid& playlistUuid) const;
 
     bool writeChangedPlaylists();
 
-    std::optional<std::string> convertName(const boost::uuids::uuid& name);
-    std::optional<boost::uuids::uuid> convertName(const std::string& name);
+    std::optional<std::string> convertName(const boost::uuids::uuid& name) const;
+    std::optional<boost::uuids::uuid> convertName(const std::string& name) const;
 
-    std::optional<std::reference_wrapper<Playlist>> getPlaylistByName(const std::string& playlistName);
-    std::optional<std::reference_wrapper<Playlist>> getPlaylistByUID(const boost::uuids::uuid &uid);
+    // lookups only, a playlist is changed through the container, so the change is logged
+    const Playlist* getPlaylistByName(const std::string& playlistName) const;
+    const Playlist* getPlaylistByUID(const boost::uuids::uuid &uid) const;
 
     std::optional<const Playlist> getCurrentPlaylist() const;
     std::optional<const boost::uuids::uuid> getCurrentPlaylistUniqueID() const;
@@ -57,20 +112,27 @@ public:
     bool setCurrentPlaylist(boost::uuids::uuid&& currentPlaylistUniqueId);
     void unsetCurrentPlaylist();
 
-    bool isUniqueName(const std::string& name);
+    bool isUniqueName(const std::string& name) const;
 
     bool insertAlbumPlaylist();
 
-    std::vector<std::pair<std::string, boost::uuids::uuid>> getAllPlaylists();
+    std::vector<std::pair<std::string, boost::uuids::uuid>> getAllPlaylists() const;
+
+    // the find methods return handles into the container, the search methods copies
+    ResultList<Playlist> findPlaylists(const std::string& what, SearchAction action = SearchAction::exact) const;
+    ResultList<Playlist> findPlaylists(const boost::uuids::uuid& what, SearchAction action = SearchAction::exact) const;
+    // handles of all uuids found in list order, unknown uuids are skipped
+    ResultList<Playlist> findByUidList(const std::vector<boost::uuids::uuid>& uidList) const;
+    // one page of the result in the requested order
+    ResultList<Playlist> findPlaylists(const std::string& what, SearchAction action, const PageRequest& page) const;
 
-    std::vector<Playlist> searchPlaylists(const std::string& what, SearchAction action = SearchAction::exact);
-    std::vector<Playlist> searchPlaylists(const boost::uuids::uuid& what, SearchAction action = SearchAction::exact);
+    std::vector<Playlist> searchPlaylists(const std::string& what, SearchAction action = SearchAction::exact) const;
+    std::vector<Playlist> searchPlaylists(const boost::uuids::uuid& what, SearchAction action = SearchAction::exact) const;
 
-    std::optional<const boost::uuids::uuid> getUIDByName(const std::string& name) {
-        auto it = std::find_if(std::begin(m_playlists), std::end(m_playlists), [&name](const Playlist& item){ return item.getName() == name; });
-        if (it != std::end(m_playlists))
-            return std::nullopt;
-        return it->getUniqueID();
+    std::optional<const boost::uuids::uuid> getUIDByName(const std::string& name) const {
+        if (auto position = findByName(name))
+            return m_playlists[*position].getUniqueID();
+        return std::nullopt;
     }
 
     void insertTagsFromItems(const Database::Id3Repository& repository);
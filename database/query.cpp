@@ -0,0 +1,187 @@
+#include "query.h"
+#include <stack>
+
+using namespace Database;
+
+namespace {
+
+constexpr char andOperator { '&' };
+constexpr char orOperator { '|' };
+constexpr char notOperator { '!' };
+constexpr char openParenthesis { '(' };
+constexpr char closeParenthesis { ')' };
+
+bool isOperatorToken(const std::string& token) {
+    return token.length() == 1 &&
+            (token[0] == andOperator || token[0] == orOperator || token[0] == notOperator ||
+             token[0] == openParenthesis || token[0] == closeParenthesis);
+}
+
+Query::Operation toOperation(char op) {
+    switch (op) {
+    case andOperator: return Query::Operation::conjunction;
+    case orOperator: return Query::Operation::disjunction;
+    default: return Query::Operation::negate;
+    }
+}
+
+// binding strength: not > and > or
+int precedence(char op) {
+    switch (op) {
+    case notOperator: return 3;
+    case andOperator: return 2;
+    case orOperator: return 1;
+    default: return 0;
+    }
+}
+
+}
+
+std::vector<std::string> Query::tokenize(const std::vector<std::string>& whatList) {
+
+    std::vector<std::string> tokenList;
+
+    // separate leading "(" and "!" and trailing ")" from the search words, e.g. "(!live)"
+    for (const auto& what : whatList) {
+        if (isOperatorToken(what)) {
+            tokenList.push_back(what);
+            continue;
+        }
+
+        std::size_t begin {0};
+        std::size_t end {what.length()};
+        while (begin < end && (what[begin] == openParenthesis || what[begin] == notOperator)) {
+            tokenList.emplace_back(1, what[begin]);
+            ++begin;
+        }
+
+        std::size_t closing {0};
+        while (end > begin && what[end-1] == closeParenthesis) {
+            ++closing;
+            --end;
+        }
+
+        if (end > begin)
+            tokenList.push_back(what.substr(begin, end-begin));
+
+        for (std::size_t i{0}; i < closing; ++i)
+            tokenList.emplace_back(1, closeParenthesis);
+    }
+
+    return tokenList;
+}
+
+std::optional<std::vector<Query::Step>> Query::compileInfix(const std::vector<std::string>& tokenList) {
+
+    // shunting yard: operand and binary operator must alternate
+    std::vector<Step> plan;
+    std::stack<char> operatorStack;
+    bool expectOperand {true};
+
+    for (const auto& token : tokenList) {
+        if (!isOperatorToken(token)) {
+            if (!expectOperand)
+                return std::nullopt;
+            plan.push_back({Operation::leaf, token});
+            expectOperand = false;
+            continue;
+        }
+
+        char op = token[0];
+
+        if (op == openParenthesis || op == notOperator) {
+            if (!expectOperand)
+                return std::nullopt;
+            operatorStack.push(op);
+        }
+        else if (op == closeParenthesis) {
+            if (expectOperand)
+                return std::nullopt;
+            while (!operatorStack.empty() && operatorStack.top() != openParenthesis) {
+                plan.push_back({toOperation(operatorStack.top()), {}});
+                operatorStack.pop();
+            }
+            if (operatorStack.empty())
+                return std::nullopt;
+            operatorStack.pop();
+        }
+        else {
+            if (expectOperand)
+                return std::nullopt;
+            while (!operatorStack.empty() && operatorStack.top() != openParenthesis &&
+                   precedence(operatorStack.top()) >= precedence(op)) {
+                plan.push_back({toOperation(operatorStack.top()), {}});
+                operatorStack.pop();
+            }
+            operatorStack.push(op);
+            expectOperand = true;
+        }
+    }
+
+    if (expectOperand)
+        return std::nullopt;
+
+    while (!operatorStack.empty()) {
+        if (operatorStack.top() == openParenthesis)
+            return std::nullopt;
+        plan.push_back({toOperation(operatorStack.top()), {}});
+        operatorStack.pop();
+    }
+
+    return plan;
+}
+
+std::optional<std::vector<Query::Step>> Query::compilePostfix(const std::vector<std::string>& tokenList) {
+
+    std::vector<Step> plan;
+    std::size_t depth {0};
+
+    for (const auto& token : tokenList) {
+        if (!isOperatorToken(token)) {
+            plan.push_back({Operation::leaf, token});
+            ++depth;
+            continue;
+        }
+
+        char op = token[0];
+        if (op == openParenthesis || op == closeParenthesis)
+            return std::nullopt;
+
+        std::size_t operandCount = (op == notOperator) ? 1 : 2;
+        if (depth < operandCount)
+            return std::nullopt;
+
+        depth -= operandCount - 1;
+        plan.push_back({toOperation(op), {}});
+    }
+
+    if (depth != 1)
+        return std::nullopt;
+
+    return plan;
+}
+
+bool Query::isExpression(const std::vector<std::string>& whatList) {
+    for (const auto& what : whatList) {
+        if (what.empty())
+            continue;
+        if (what == "&" || what == "|" ||
+                what.front() == openParenthesis || what.front() == notOperator ||
+                what.back() == closeParenthesis)
+            return true;
+    }
+    return false;
+}
+
+std::optional<Query> Query::compile(const std::vector<std::string>& whatList) {
+
+    auto tokenList = tokenize(whatList);
+
+    if (auto plan = compileInfix(tokenList))
+        return Query(std::move(*plan));
+
+    if (auto plan = compilePostfix(tokenList))
+        return Query(std::move(*plan));
+
+    return std::nullopt;
+}
@@ -0,0 +1,92 @@
+#ifndef DATABASE_QUERY_H
+#define DATABASE_QUERY_H
+
+#include <vector>
+#include <string>
+#include <optional>
+#include "querybitset.h"
+
+namespace Database {
+
+/*!
+ * \brief Query is a compiled boolean search expression.
+ * Search words can be combined with "&" (and), "|" (or), "!" (not) and parentheses,
+ * e.g. "(beatles | stones) & !live". The former postfix notation ("beatles stones |")
+ * is still accepted.
+ * The expression is compiled once into a postfix plan. Evaluation asks the caller
+ * for one bitset per search word (the leaf predicate) and combines these bitsets
+ * word-at-a-time, so the records are never walked per operator.
+ */
+class Query {
+
+public:
+    enum class Operation {
+        leaf,
+        negate,
+        conjunction,
+        disjunction
+    };
+
+    struct Step {
+        Operation operation;
+        std::string what;
+    };
+
+private:
+    std::vector<Step> m_plan;
+
+    explicit Query(std::vector<Step>&& plan) : m_plan(std::move(plan)) {}
+
+    static std::vector<std::string> tokenize(const std::vector<std::string>& whatList);
+    static std::optional<std::vector<Step>> compileInfix(const std::vector<std::string>& tokenList);
+    static std::optional<std::vector<Step>> compilePostfix(const std::vector<std::string>& tokenList);
+
+public:
+
+    // true if the (lowercase) word list contains any operator or parenthesis
+    static bool isExpression(const std::vector<std::string>& whatList);
+
+    // nullopt if the expression is malformed
+    static std::optional<Query> compile(const std::vector<std::string>& whatList);
+
+    const std::vector<Step>& plan() const { return m_plan; }
+
+    template <typename LeafFunc>
+    QueryBitSet evaluate(std::size_t recordCount, LeafFunc&& leafFunc) const {
+        std::vector<QueryBitSet> stack;
+
+        for (const auto& step : m_plan) {
+            switch (step.operation) {
+            case Operation::leaf:
+                stack.emplace_back(leafFunc(step.what));
+                break;
+            case Operation::negate:
+                stack.back().flip();
+                break;
+            case Operation::conjunction: {
+                auto operand = std::move(stack.back());
+                stack.pop_back();
+                stack.back() &= operand;
+                break;
+            }
+            case Operation::disjunction: {
+                auto operand = std::move(stack.back());
+                stack.pop_back();
+                stack.back() |= operand;
+                break;
+            }
+            }
+        }
+
+        // compile() only creates plans, that leave exactly one result
+        if (stack.size() != 1)
+            return QueryBitSet(recordCount);
+
+        return std::move(stack.back());
+    }
+
+};
+
+}
+
+#endif // DATABASE_QUERY_H
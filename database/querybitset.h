@@ -0,0 +1,84 @@
+#ifndef DATABASE_QUERYBITSET_H
+#define DATABASE_QUERYBITSET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Database {
+
+/*!
+ * \brief QueryBitSet is a dense bitset over the record positions of a repository.
+ * Boolean operations are done on complete 64 bit words, so combining the
+ * results of several query predicates costs (records/64) operations.
+ */
+class QueryBitSet {
+
+    using Word = uint64_t;
+    static constexpr std::size_t wordBits { 64 };
+
+    std::vector<Word> m_words;
+    std::size_t m_size { 0 };
+
+    // bits behind m_size must stay zero, otherwise count() and forEach() would see them
+    void clearTail() {
+        if (auto rest = m_size % wordBits)
+            m_words.back() &= (Word(1) << rest) - 1;
+    }
+
+public:
+
+    QueryBitSet() = default;
+    explicit QueryBitSet(std::size_t size, bool value = false)
+        : m_words((size + wordBits - 1) / wordBits, value ? ~Word(0) : Word(0)), m_size(size) {
+        clearTail();
+    }
+
+    std::size_t size() const { return m_size; }
+
+    void set(std::size_t position) { m_words[position / wordBits] |= Word(1) << (position % wordBits); }
+    bool test(std::size_t position) const { return (m_words[position / wordBits] >> (position % wordBits)) & 1; }
+
+    QueryBitSet& operator&=(const QueryBitSet& other) {
+        for (std::size_t i{0}; i < m_words.size(); ++i)
+            m_words[i] &= other.m_words[i];
+        return *this;
+    }
+
+    QueryBitSet& operator|=(const QueryBitSet& other) {
+        for (std::size_t i{0}; i < m_words.size(); ++i)
+            m_words[i] |= other.m_words[i];
+        return *this;
+    }
+
+    QueryBitSet& flip() {
+        for (auto& word : m_words)
+            word = ~word;
+        clearTail();
+        return *this;
+    }
+
+    std::size_t count() const {
+        std::size_t bits {0};
+        for (const auto& word : m_words)
+            bits += static_cast<std::size_t>(__builtin_popcountll(word));
+        return bits;
+    }
+
+    // call func with every set position in ascending order
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (std::size_t i{0}; i < m_words.size(); ++i) {
+            Word word = m_words[i];
+            while (word) {
+                func(i * wordBits + static_cast<std::size_t>(__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+};
+
+}
+
+#endif // DATABASE_QUERYBITSET_H
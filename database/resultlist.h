@@ -0,0 +1,60 @@
+#ifndef DATABASE_RESULTLIST_H
+#define DATABASE_RESULTLIST_H
+
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <boost/iterator/indirect_iterator.hpp>
+
+namespace Database {
+
+/*!
+ * \brief ResultList is the result of a search: a list of handles to the records
+ * found, not copies of them. Iterating the list gives const references into the
+ * repository.
+ * The handles are valid until the repository is modified, so the result must be
+ * serialized (or copied with toVector()) before any record is added or removed.
+ */
+template <typename Record>
+class ResultList {
+
+    std::vector<const Record*> m_records;
+    std::optional<std::size_t> m_nextCursor; //< set, if the list is one page and more results follow
+
+public:
+    using const_iterator = boost::indirect_iterator<typename std::vector<const Record*>::const_iterator>;
+
+    void push_back(const Record& record) { m_records.push_back(&record); }
+    void reserve(std::size_t size) { m_records.reserve(size); }
+
+    std::size_t size() const { return m_records.size(); }
+    bool empty() const { return m_records.empty(); }
+
+    const Record& operator[](std::size_t position) const { return *m_records[position]; }
+
+    std::optional<std::size_t> nextCursor() const { return m_nextCursor; }
+    void setNextCursor(std::optional<std::size_t> cursor) { m_nextCursor = cursor; }
+
+    const_iterator begin() const { return const_iterator(std::cbegin(m_records)); }
+    const_iterator end() const { return const_iterator(std::cend(m_records)); }
+
+    // reorder the handles only, the records stay in place
+    template <typename Compare>
+    void sort(Compare&& compare) {
+        std::sort(std::begin(m_records), std::end(m_records),
+                  [&compare](const Record* record1, const Record* record2) { return compare(*record1, *record2); });
+    }
+
+    std::vector<Record> toVector() const {
+        std::vector<Record> recordList;
+        recordList.reserve(m_records.size());
+        for (const auto& record : m_records)
+            recordList.push_back(*record);
+        return recordList;
+    }
+
+};
+
+}
+
+#endif // DATABASE_RESULTLIST_H
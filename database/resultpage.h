@@ -0,0 +1,150 @@
+#ifndef DATABASE_RESULTPAGE_H
+#define DATABASE_RESULTPAGE_H
+
+#include <vector>
+#include <optional>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include "querybitset.h"
+#include "resultlist.h"
+
+namespace Database {
+
+enum class SortOrder {
+    unsorted,   //< storage order
+    relevance,  //< best matching first
+    name,
+    performer,
+    added       //< latest added first
+};
+
+/*!
+ * \brief PageRequest cuts one page out of a search result. The cursor of the next
+ * page is given back with the result list and is only meaningful for the same
+ * search and sort order.
+ */
+struct PageRequest {
+    std::size_t limit { 0 }; //< 0 returns all results
+    std::size_t cursor { 0 };
+    SortOrder order { SortOrder::unsorted };
+};
+
+// rows 0..size-1 sorted by less, used as precomputed browse order of a repository
+template <typename Less>
+std::vector<uint32_t> buildOrder(std::size_t size, Less&& less) {
+    std::vector<uint32_t> order(size);
+    std::iota(std::begin(order), std::end(order), 0);
+    std::stable_sort(std::begin(order), std::end(order), less);
+    return order;
+}
+
+namespace Page {
+
+// walk the rows in storage order, the cursor is the row to continue with
+template <typename Func>
+std::optional<std::size_t> byRow(const QueryBitSet& result, const PageRequest& page, Func&& func) {
+    std::size_t taken {0};
+    for (auto row = page.cursor; row < result.size(); ++row) {
+        if (!result.test(row))
+            continue;
+        if (page.limit && taken == page.limit)
+            return row;
+        func(row);
+        ++taken;
+    }
+    return std::nullopt;
+}
+
+// walk a precomputed order, the cursor is the position within the order to continue with
+template <typename Func>
+std::optional<std::size_t> byOrder(const std::vector<uint32_t>& order, const QueryBitSet& result, const PageRequest& page, Func&& func) {
+    std::size_t taken {0};
+    for (auto position = page.cursor; position < order.size(); ++position) {
+        if (!result.test(order[position]))
+            continue;
+        if (page.limit && taken == page.limit)
+            return position;
+        func(order[position]);
+        ++taken;
+    }
+    return std::nullopt;
+}
+
+/*
+ * Only the best (cursor + limit) rows are kept in a heap, the result is never sorted
+ * as a whole. The cursor is the number of rows given out by the former pages.
+ */
+template <typename Score, typename Func>
+std::optional<std::size_t> byScore(const QueryBitSet& result, const PageRequest& page, Score&& score, Func&& func) {
+
+    using Entry = std::pair<int, uint32_t>;
+    // higher score first, storage order on equal score
+    auto better = [](const Entry& entry1, const Entry& entry2) {
+        return entry1.first > entry2.first || (entry1.first == entry2.first && entry1.second < entry2.second);
+    };
+
+    auto total = result.count();
+    auto keep = page.limit ? std::min(total, page.cursor + page.limit) : total;
+
+    // the front of the heap is the worst entry kept so far
+    std::vector<Entry> heap;
+    heap.reserve(keep);
+    result.forEach([&](std::size_t row) {
+        Entry entry { score(row), static_cast<uint32_t>(row) };
+        if (heap.size() < keep) {
+            heap.push_back(entry);
+            std::push_heap(std::begin(heap), std::end(heap), better);
+        }
+        else if (keep > 0 && better(entry, heap.front())) {
+            std::pop_heap(std::begin(heap), std::end(heap), better);
+            heap.back() = entry;
+            std::push_heap(std::begin(heap), std::end(heap), better);
+        }
+    });
+    std::sort_heap(std::begin(heap), std::end(heap), better);
+
+    for (auto position = page.cursor; position < heap.size(); ++position)
+        func(heap[position].second);
+
+    if (keep < total)
+        return keep;
+    return std::nullopt;
+}
+
+}
+
+/*!
+ * \brief paginate cuts the requested page out of a result list, that holds handles into storage.
+ * orderOf gives the precomputed order for a sort order, score the relevance of a row.
+ */
+template <typename Record, typename OrderFunc, typename ScoreFunc>
+ResultList<Record> paginate(const ResultList<Record>& findData, const std::vector<Record>& storage,
+                            const PageRequest& page, OrderFunc&& orderOf, ScoreFunc&& score) {
+
+    QueryBitSet result(storage.size());
+    for (const auto& record : findData)
+        result.set(static_cast<std::size_t>(&record - storage.data()));
+
+    ResultList<Record> pageData;
+    pageData.reserve(page.limit ? std::min(page.limit, findData.size()) : findData.size());
+    auto take = [&pageData, &storage](std::size_t row) { pageData.push_back(storage[row]); };
+
+    switch (page.order) {
+    case SortOrder::unsorted:
+        pageData.setNextCursor(Page::byRow(result, page, take));
+        break;
+    case SortOrder::relevance:
+        pageData.setNextCursor(Page::byScore(result, page, score, take));
+        break;
+    default:
+        pageData.setNextCursor(Page::byOrder(orderOf(page.order), result, page, take));
+        break;
+    }
+
+    return pageData;
+}
+
+}
+
+#endif // DATABASE_RESULTPAGE_H
@@ -0,0 +1,75 @@
+#ifndef DATABASE_SNAPSHOT_H
+#define DATABASE_SNAPSHOT_H
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+
+namespace Database {
+
+/*!
+ * \brief Snapshot publishes immutable versions of a database (read-copy-update).
+ * A reader takes the current version and keeps it as long as needed, it is never
+ * changed underneath. A writer changes a copy of the current version and publishes
+ * it as a whole, so readers see either the old or the new version.
+ * Writers are serialized, readers never wait for them.
+ */
+template <typename T>
+class Snapshot {
+
+    std::shared_ptr<const T> m_current;
+    std::mutex m_writeMutex;
+
+public:
+    explicit Snapshot(std::shared_ptr<T> initial) : m_current(std::move(initial)) {}
+
+    std::shared_ptr<const T> read() const { return std::atomic_load(&m_current); }
+
+    // change a copy of the current version, that is published after seal() built all lazy data
+    template <typename Func>
+    auto update(Func&& change) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        auto next = std::make_shared<T>(*read());
+        auto finish = [this, &next]() {
+            next->seal();
+            std::atomic_store(&m_current, std::shared_ptr<const T>(std::move(next)));
+        };
+        if constexpr (std::is_void_v<decltype(change(*next))>) {
+            change(*next);
+            finish();
+        }
+        else {
+            auto result = change(*next);
+            finish();
+            return result;
+        }
+    }
+};
+
+/*!
+ * \brief CopyOnWrite shares a part of a database between its versions. The part is
+ * copied on the first change of a version, only if other versions still hold it.
+ */
+template <typename T>
+class CopyOnWrite {
+
+    std::shared_ptr<T> m_value;
+
+public:
+    CopyOnWrite() : m_value(std::make_shared<T>()) {}
+    explicit CopyOnWrite(std::shared_ptr<T> value) : m_value(std::move(value)) {}
+
+    const T& operator*() const { return *m_value; }
+    const T* operator->() const { return m_value.get(); }
+
+    T& write() {
+        if (m_value.use_count() > 1)
+            m_value = std::make_shared<T>(*m_value);
+        return *m_value;
+    }
+};
+
+}
+
+#endif // DATABASE_SNAPSHOT_H
@@ -1,21 +1,15 @@
 #include "songtagreader.h"
 #include "common/logger.h"
+#include "common/stringmanipulator.h"
 #include <boost/algorithm/string/trim.hpp>
 
 using namespace LoggerFramework;
 using namespace Database;
 
 void SongTagReader::addTagId(std::string &&identifier, Tag &&tag) {
-    m_tagList.emplace_back(TagItem(std::move(identifier), std::move(tag)));
-}
-
-SongTagReader::TagList::iterator SongTagReader::find(const std::string &searchName) {
-    auto it = std::find_if(std::begin(m_tagList),
-                           std::end(m_tagList),
-                           [&searchName](const TagItem& item)
-    { return item.fullSearchName == searchName; }
-    );
-    return it;
+    auto [entry, isNew] = m_tagList.try_emplace(std::move(identifier));
+    logger(Level::debug) << (isNew ? " - entry is new\n" : " - entry is available\n");
+    entry->second.emplace_back(std::move(tag));
 }
 
 void SongTagReader::readSongTagFile() {
@@ -29,6 +23,11 @@ void SongTagReader::readSongTagFile() {
         return;
     }
 
+    readSongTagList(inStream);
+}
+
+void SongTagReader::readSongTagList(std::istream &inStream) {
+
     for (std::string line; std::getline(inStream, line); ) {
 
         boost::trim(line);
@@ -50,16 +49,20 @@ void SongTagReader::readSongTagFile() {
             continue;
         }
 
-        auto entry = find(identifier);
-        if (entry != m_tagList.end()) {
-            logger(Level::debug) << " - entry is available\n";
-            entry->tags.emplace_back(std::move(tag));
-        }
-        else {
-            logger(Level::debug) << " - entry is new\n";
-            addTagId(std::move(identifier), std::move(tag));
+        // the stored names are normalized, so is every stage of the identifier
+        std::string key;
+        for (std::size_t start{0}; start <= identifier.length(); ) {
+            auto end = std::min(identifier.find(':', start), identifier.length());
+            auto stage = identifier.substr(start, end - start);
+            boost::trim(stage);
+            if (start > 0)
+                key.append(":");
+            key.append(Common::normalize(stage));
+            start = end + 1;
         }
 
+        addTagId(std::move(key), std::move(tag));
+
     }
 
 }
@@ -68,23 +71,22 @@ std::vector<Tag> SongTagReader::findSongTagList(const std::string &albumName, co
 
     std::vector<Tag> songTagList;
 
-    std::string stage1 = performerName + ":" + albumName + ":" + titleName;
-    std::string stage2 = performerName + ":" + albumName;
-    std::string stage3 = performerName;
+    if (m_tagList.empty())
+        return songTagList;
 
-    for (const auto& elem : m_tagList) {
-        // first find tags for title only
-        if (stage1 == elem.fullSearchName) {
-            logger(LoggerFramework::Level::info) << "enrich <"<<stage1<<"> with " << (int) elem.tags[0] << "\n";
-            songTagList.insert(songTagList.end(), std::begin(elem.tags), std::end(elem.tags));
-        }
-        else if (stage2 == elem.fullSearchName) {
-            logger(LoggerFramework::Level::info) << "enrich <"<<stage2<<"> with " << (int) elem.tags[0] << "\n";
-            songTagList.insert(songTagList.end(), std::begin(elem.tags), std::end(elem.tags));
-        }
-        else if (stage3 == elem.fullSearchName) {
-            logger(LoggerFramework::Level::info) << "enrich <"<<stage3<<"> with " << (int) elem.tags[0] << "\n";
-            songTagList.insert(songTagList.end(), std::begin(elem.tags), std::end(elem.tags));
+    // the shorter stages are prefixes of the title stage, so one key is cut down step by step
+    std::string key;
+    key.reserve(performerName.length() + albumName.length() + titleName.length() + 2);
+    key.append(performerName).append(":").append(albumName).append(":").append(titleName);
+
+    const std::size_t stageLength[] { key.length(), performerName.length() + 1 + albumName.length(), performerName.length() };
+
+    for (auto length : stageLength) {
+        key.resize(length);
+        auto entry = m_tagList.find(key);
+        if (entry != std::end(m_tagList)) {
+            logger(LoggerFramework::Level::info) << "enrich <"<<key<<"> with " << (int) entry->second[0] << "\n";
+            songTagList.insert(songTagList.end(), std::begin(entry->second), std::end(entry->second));
         }
     }
 
@@ -5,6 +5,8 @@
 #include <string>
 #include <algorithm>
 #include <fstream>
+#include <istream>
+#include <unordered_map>
 
 #include "id3tagreader/idtag.h"
 #include "common/filesystemadditions.h"
@@ -13,24 +15,22 @@ namespace Database {
 
 class SongTagReader {
 
-    struct TagItem {
-        std::string fullSearchName;
-        std::vector<Tag> tags;
-        TagItem(std::string&& searchName, Tag&& tag)
-            : fullSearchName(searchName) { tags.emplace_back(tag); }
-    };
-
-    typedef std::vector<TagItem> TagList;
+    /*
+     * identifier of all stages (performer, performer:album, performer:album:title)
+     * to its tags, so a song is enriched by three lookups
+     */
+    typedef std::unordered_map<std::string, std::vector<Tag>> TagList;
     TagList m_tagList;
 
     void addTagId(std::string&& identifier, Tag&& tag);
 
-    TagList::iterator find(const std::string& searchName);
-
 
 public:
     void readSongTagFile();
 
+    // lines of "performer[:album[:title]] | tag", every stage of the identifier is normalized
+    void readSongTagList(std::istream& inStream);
+
     std::vector<Tag> findSongTagList(const std::string& albumName,
                                      const std::string& titleName,
                                      const std::string& performerName) const;
@@ -0,0 +1,183 @@
+#include "textcolumn.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEXTCOLUMN_X86
+#endif
+
+using namespace Database;
+
+namespace {
+
+// maps a blob position to its row, positions are mostly fed in ascending order
+class RowCursor {
+    const std::vector<uint32_t>& m_offsets;
+    std::size_t m_row {0};
+
+public:
+    explicit RowCursor(const std::vector<uint32_t>& offsets) : m_offsets(offsets) {}
+
+    std::size_t rowOf(std::size_t position) {
+        if (position < m_offsets[m_row]) {
+            auto it = std::upper_bound(std::begin(m_offsets), std::begin(m_offsets) + static_cast<std::ptrdiff_t>(m_row) + 1, position);
+            m_row = static_cast<std::size_t>(std::distance(std::begin(m_offsets), it)) - 1;
+        }
+        while (m_offsets[m_row+1] <= position)
+            ++m_row;
+        return m_row;
+    }
+
+    std::size_t rowEnd(std::size_t row) const { return m_offsets[row+1]; }
+};
+
+// check the needle bytes between the first and the last one (these are already compared)
+inline bool matchesInner(const char* text, const std::string& needle) {
+    return needle.length() <= 2 || std::memcmp(text + 1, needle.data() + 1, needle.length() - 2) == 0;
+}
+
+void scanScalar(const std::string& blob, std::size_t begin, const std::vector<std::string>& needleList,
+                RowCursor& cursor, QueryBitSet& result) {
+
+    std::string_view text(blob);
+
+    for (const auto& needle : needleList) {
+        std::size_t position = text.find(needle, begin);
+        while (position != std::string_view::npos) {
+            auto row = cursor.rowOf(position);
+            result.set(row);
+            // one match per row is enough, continue with the next row
+            position = text.find(needle, cursor.rowEnd(row));
+        }
+    }
+}
+
+#ifdef TEXTCOLUMN_X86
+
+/*
+ * Filter with the first and the last byte of each needle: compare a block of the blob
+ * with the broadcasted first byte and the block shifted by (length-1) with the
+ * broadcasted last byte. Only positions passing both compares are verified.
+ * All needles are checked on the same block before moving on, so the blob is
+ * read once for the whole needle list.
+ * Returns the position, where the scalar scan must continue.
+ */
+std::size_t scanSse2(const std::string& blob, const std::vector<std::string>& needleList,
+                     std::size_t maxLength, RowCursor& cursor, QueryBitSet& result) {
+
+    constexpr std::size_t blockSize { sizeof(__m128i) };
+
+    const char* data = blob.data();
+    std::size_t position {0};
+
+    for (; position + blockSize + maxLength - 1 <= blob.length(); position += blockSize) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+
+        for (const auto& needle : needleList) {
+            const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + needle.length() - 1));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, _mm_set1_epi8(needle.front())),
+                                                                              _mm_cmpeq_epi8(blockLast, _mm_set1_epi8(needle.back())))));
+            while (mask) {
+                auto match = position + static_cast<std::size_t>(__builtin_ctz(mask));
+                if (matchesInner(data + match, needle))
+                    result.set(cursor.rowOf(match));
+                mask &= mask - 1;
+            }
+        }
+    }
+
+    return position;
+}
+
+__attribute__((target("avx2")))
+std::size_t scanAvx2(const std::string& blob, const std::vector<std::string>& needleList,
+                     std::size_t maxLength, RowCursor& cursor, QueryBitSet& result) {
+
+    constexpr std::size_t blockSize { sizeof(__m256i) };
+
+    const char* data = blob.data();
+    std::size_t position {0};
+
+    for (; position + blockSize + maxLength - 1 <= blob.length(); position += blockSize) {
+        const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+
+        for (const auto& needle : needleList) {
+            const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position + needle.length() - 1));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, _mm256_set1_epi8(needle.front())),
+                                                                                    _mm256_cmpeq_epi8(blockLast, _mm256_set1_epi8(needle.back())))));
+            while (mask) {
+                auto match = position + static_cast<std::size_t>(__builtin_ctz(mask));
+                if (matchesInner(data + match, needle))
+                    result.set(cursor.rowOf(match));
+                mask &= mask - 1;
+            }
+        }
+    }
+
+    return position;
+}
+
+#endif
+
+}
+
+void TextColumn::reserve(std::size_t rows, std::size_t bytes) {
+    m_offsets.reserve(rows + 1);
+    m_blob.reserve(bytes);
+}
+
+void TextColumn::append(std::string_view text) {
+    m_blob.append(text);
+    m_blob.push_back('\0');
+    m_offsets.push_back(static_cast<uint32_t>(m_blob.length()));
+}
+
+void TextColumn::clear() {
+    m_blob.clear();
+    m_offsets.assign(1, 0);
+}
+
+TextColumn::Implementation TextColumn::bestImplementation() {
+#ifdef TEXTCOLUMN_X86
+    static const Implementation best = __builtin_cpu_supports("avx2") ? Implementation::avx2 : Implementation::sse2;
+    return best;
+#else
+    return Implementation::scalar;
+#endif
+}
+
+void TextColumn::findAny(const std::vector<std::string>& needleList, QueryBitSet& result, Implementation implementation) const {
+
+    if (rows() == 0 || needleList.empty())
+        return;
+
+    // an empty needle is found in every row
+    if (std::any_of(std::begin(needleList), std::end(needleList), [](const std::string& needle) { return needle.empty(); })) {
+        for (std::size_t row{0}; row < rows(); ++row)
+            result.set(row);
+        return;
+    }
+
+    if (implementation == Implementation::automatic)
+        implementation = bestImplementation();
+
+    RowCursor cursor(m_offsets);
+    std::size_t scalarBegin {0};
+
+#ifdef TEXTCOLUMN_X86
+    std::size_t maxLength {0};
+    for (const auto& needle : needleList)
+        maxLength = std::max(maxLength, needle.length());
+
+    if (implementation == Implementation::avx2)
+        scalarBegin = scanAvx2(m_blob, needleList, maxLength, cursor, result);
+    else if (implementation == Implementation::sse2)
+        scalarBegin = scanSse2(m_blob, needleList, maxLength, cursor, result);
+#endif
+
+    // the tail of the blob (shorter than a vector block plus the needle)
+    if (scalarBegin < m_blob.length())
+        scanScalar(m_blob, scalarBegin, needleList, cursor, result);
+}
@@ -0,0 +1,55 @@
+#ifndef DATABASE_TEXTCOLUMN_H
+#define DATABASE_TEXTCOLUMN_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "querybitset.h"
+
+namespace Database {
+
+/*!
+ * \brief TextColumn holds one searchable (lowercase) field of all records packed
+ * into a single contiguous blob. Row r is found at m_offsets[r] and is terminated
+ * by a '\0', so a needle can never match across two rows.
+ * Scanning the blob reads only the bytes of this field, instead of walking the
+ * records and touching a full object per comparison.
+ */
+class TextColumn {
+
+public:
+    enum class Implementation {
+        automatic,
+        scalar,
+        sse2,
+        avx2
+    };
+
+private:
+    std::string m_blob;
+    std::vector<uint32_t> m_offsets { 0 };
+
+public:
+
+    void reserve(std::size_t rows, std::size_t bytes);
+    void append(std::string_view text);
+    void clear();
+
+    std::size_t rows() const { return m_offsets.size() - 1; }
+    std::string_view text(std::size_t row) const {
+        return std::string_view(m_blob.data() + m_offsets[row], m_offsets[row+1] - m_offsets[row] - 1);
+    }
+
+    // set the bits of all rows containing at least one of the needles
+    void findAny(const std::vector<std::string>& needleList, QueryBitSet& result,
+                 Implementation implementation = Implementation::automatic) const;
+
+    // best implementation supported by this cpu
+    static Implementation bestImplementation();
+
+};
+
+}
+
+#endif // DATABASE_TEXTCOLUMN_H
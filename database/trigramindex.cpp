@@ -0,0 +1,104 @@
+#include "trigramindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Database;
+
+namespace {
+
+std::vector<uint32_t> extractGrams(std::string_view text) {
+    std::vector<uint32_t> gramList;
+    if (text.length() < TrigramIndex::gramLength)
+        return gramList;
+
+    gramList.reserve(text.length() - TrigramIndex::gramLength + 1);
+    for (std::size_t pos{0}; pos + TrigramIndex::gramLength <= text.length(); ++pos) {
+        gramList.push_back(static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) |
+                           static_cast<uint32_t>(static_cast<unsigned char>(text[pos+1])) << 8 |
+                           static_cast<uint32_t>(static_cast<unsigned char>(text[pos+2])) << 16);
+    }
+    std::sort(std::begin(gramList), std::end(gramList));
+    gramList.erase(std::unique(std::begin(gramList), std::end(gramList)), std::end(gramList));
+    return gramList;
+}
+
+}
+
+void TrigramIndex::add(RowId row, std::string_view text) {
+    for (const auto& gram : extractGrams(text)) {
+        auto& postingList = m_postings[gram];
+        // rows are usually added in ascending order, so appending is the common case
+        if (postingList.empty() || postingList.back() < row) {
+            postingList.push_back(row);
+        }
+        else {
+            auto it = std::lower_bound(std::begin(postingList), std::end(postingList), row);
+            if (it == std::end(postingList) || *it != row)
+                postingList.insert(it, row);
+        }
+    }
+}
+
+void TrigramIndex::remove(RowId row, std::string_view text) {
+    for (const auto& gram : extractGrams(text)) {
+        auto postingIt = m_postings.find(gram);
+        if (postingIt == std::end(m_postings))
+            continue;
+        auto& postingList = postingIt->second;
+        auto it = std::lower_bound(std::begin(postingList), std::end(postingList), row);
+        if (it != std::end(postingList) && *it == row)
+            postingList.erase(it);
+        if (postingList.empty())
+            m_postings.erase(postingIt);
+    }
+}
+
+std::optional<std::vector<TrigramIndex::RowId>> TrigramIndex::candidates(std::string_view needle) const {
+
+    if (!isIndexable(needle))
+        return std::nullopt;
+
+    std::vector<const std::vector<RowId>*> postingLists;
+    for (const auto& gram : extractGrams(needle)) {
+        auto postingIt = m_postings.find(gram);
+        if (postingIt == std::end(m_postings))
+            return std::vector<RowId>();
+        postingLists.push_back(&postingIt->second);
+    }
+
+    // start with the shortest list, so the intersection shrinks as fast as possible
+    std::sort(std::begin(postingLists), std::end(postingLists),
+              [](const auto* list1, const auto* list2) { return list1->size() < list2->size(); });
+
+    std::vector<RowId> candidateList { *postingLists.front() };
+    std::vector<RowId> intersection;
+    for (auto it = std::next(std::begin(postingLists)); it != std::end(postingLists) && !candidateList.empty(); ++it) {
+        intersection.clear();
+        std::set_intersection(std::begin(candidateList), std::end(candidateList),
+                              std::begin(**it), std::end(**it),
+                              std::back_inserter(intersection));
+        candidateList.swap(intersection);
+    }
+
+    return candidateList;
+}
+
+TrigramIndex::Flat TrigramIndex::flatten() const {
+
+    Flat flat;
+    flat.gramList.reserve(m_postings.size());
+    for (const auto& posting : m_postings)
+        flat.gramList.push_back(posting.first);
+    std::sort(std::begin(flat.gramList), std::end(flat.gramList));
+
+    flat.offsetList.reserve(flat.gramList.size() + 1);
+    for (const auto& gram : flat.gramList) {
+        const auto& postingList = m_postings.at(gram);
+        flat.offsetList.push_back(static_cast<uint32_t>(flat.rowList.size()));
+        flat.rowList.insert(std::end(flat.rowList), std::begin(postingList), std::end(postingList));
+    }
+    flat.offsetList.push_back(static_cast<uint32_t>(flat.rowList.size()));
+
+    return flat;
+}
@@ -0,0 +1,84 @@
+#ifndef DATABASE_TRIGRAMINDEX_H
+#define DATABASE_TRIGRAMINDEX_H
+
+#include <vector>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <unordered_map>
+#include <iterator>
+
+namespace Database {
+
+/*!
+ * \brief TrigramIndex is an inverted index from every 3 byte sequence of a text to
+ * the (sorted) list of rows containing that sequence.
+ * A substring search intersects the posting lists of all trigrams of the
+ * needle. The result is a candidate list, that must be verified by the caller,
+ * as the trigrams may be found at different positions of the text.
+ */
+class TrigramIndex {
+
+public:
+    using RowId = uint32_t;
+    static constexpr std::size_t gramLength { 3 };
+
+private:
+    std::unordered_map<uint32_t, std::vector<RowId>> m_postings;
+
+public:
+
+    void add(RowId row, std::string_view text);
+    void remove(RowId row, std::string_view text);
+    void clear() { m_postings.clear(); }
+
+    // rows possibly containing the needle, nullopt if the needle is too short to be searched via index
+    std::optional<std::vector<RowId>> candidates(std::string_view needle) const;
+
+    static bool isIndexable(std::string_view needle) { return needle.length() >= gramLength; }
+
+    // flat form of the index, e.g. for an index file: the sorted trigrams, the begin of
+    // their posting list within the rows (plus the end of the last one) and all posting lists
+    struct Flat {
+        std::vector<uint32_t> gramList;
+        std::vector<uint32_t> offsetList;
+        std::vector<RowId> rowList;
+    };
+
+    Flat flatten() const;
+
+    // take the flat form, unchanged if it is not valid for rowCount rows
+    template <typename GramList, typename OffsetList, typename RowList>
+    bool assign(const GramList& gramList, const OffsetList& offsetList, const RowList& rowList, std::size_t rowCount);
+
+};
+
+template <typename GramList, typename OffsetList, typename RowList>
+bool TrigramIndex::assign(const GramList& gramList, const OffsetList& offsetList, const RowList& rowList, std::size_t rowCount) {
+
+    auto gramCount = static_cast<std::size_t>(std::distance(std::begin(gramList), std::end(gramList)));
+    auto offsetCount = static_cast<std::size_t>(std::distance(std::begin(offsetList), std::end(offsetList)));
+    auto rowListSize = static_cast<std::size_t>(std::distance(std::begin(rowList), std::end(rowList)));
+    if (offsetCount != gramCount + 1 || offsetList[gramCount] != rowListSize)
+        return false;
+
+    std::unordered_map<uint32_t, std::vector<RowId>> postings;
+    postings.reserve(gramCount);
+    for (std::size_t i{0}; i < gramCount; ++i) {
+        auto begin = offsetList[i];
+        auto end = offsetList[i+1];
+        if (begin > end || end > rowListSize)
+            return false;
+        std::vector<RowId> postingList(std::begin(rowList) + begin, std::begin(rowList) + end);
+        if (!postingList.empty() && postingList.back() >= rowCount)
+            return false;
+        postings.emplace(gramList[i], std::move(postingList));
+    }
+
+    m_postings.swap(postings);
+    return true;
+}
+
+}
+
+#endif // DATABASE_TRIGRAMINDEX_H
@@ -0,0 +1,170 @@
+#ifndef DATABASE_UUIDINDEX_H
+#define DATABASE_UUIDINDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+#include <boost/uuid/uuid.hpp>
+
+namespace Database {
+
+/*!
+ * \brief UuidIndex is an open addressing (linear probing) hash map from a uuid to
+ * the slot (vector index) of the record owning this uuid.
+ * Deletion uses backward shifting, so no tombstones are needed and lookups
+ * stay short even with many add/remove cycles.
+ */
+class UuidIndex {
+
+    static constexpr uint32_t emptySlot { std::numeric_limits<uint32_t>::max() };
+    static constexpr std::size_t minCapacity { 16 };
+
+public:
+    struct Entry {
+        boost::uuids::uuid key;
+        uint32_t value { emptySlot };
+    };
+
+private:
+    std::vector<Entry> m_table;
+    std::size_t m_size { 0 };
+    std::size_t m_mask { 0 };
+
+    static std::size_t hash(const boost::uuids::uuid& uid) {
+        uint64_t high;
+        uint64_t low;
+        std::memcpy(&high, uid.data, sizeof(high));
+        std::memcpy(&low, uid.data + sizeof(high), sizeof(low));
+        uint64_t h = high ^ (low * 0x9e3779b97f4a7c15ULL);
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ULL;
+        h ^= h >> 32;
+        return static_cast<std::size_t>(h);
+    }
+
+    std::size_t findPosition(const boost::uuids::uuid& uid) const {
+        std::size_t pos = hash(uid) & m_mask;
+        while (m_table[pos].value != emptySlot && m_table[pos].key != uid) {
+            pos = (pos + 1) & m_mask;
+        }
+        return pos;
+    }
+
+    void rehash(std::size_t newCapacity) {
+        std::vector<Entry> oldTable(newCapacity);
+        oldTable.swap(m_table);
+        m_mask = newCapacity - 1;
+        for (const auto& entry : oldTable) {
+            if (entry.value != emptySlot)
+                m_table[findPosition(entry.key)] = entry;
+        }
+    }
+
+public:
+
+    UuidIndex() { rehash(minCapacity); }
+
+    // keep load factor below 1/2, so probe sequences stay short
+    void reserve(std::size_t count) {
+        std::size_t capacity { m_table.size() };
+        while (capacity < 2*count)
+            capacity *= 2;
+        if (capacity != m_table.size())
+            rehash(capacity);
+    }
+
+    // insert or update the slot for the given uuid
+    void insert(const boost::uuids::uuid& uid, std::size_t slot) {
+        if (2*(m_size+1) > m_table.size())
+            rehash(2*m_table.size());
+
+        auto& entry = m_table[findPosition(uid)];
+        if (entry.value == emptySlot) {
+            entry.key = uid;
+            ++m_size;
+        }
+        entry.value = static_cast<uint32_t>(slot);
+    }
+
+    std::optional<std::size_t> find(const boost::uuids::uuid& uid) const {
+        const auto& entry = m_table[findPosition(uid)];
+        if (entry.value == emptySlot)
+            return std::nullopt;
+        return entry.value;
+    }
+
+    // resolve a list of uuids in list order, the slots of the following uuids are prefetched
+    template <typename Func>
+    void findEach(const std::vector<boost::uuids::uuid>& uidList, Func&& func) const {
+        constexpr std::size_t prefetchDistance { 4 };
+        for (std::size_t i{0}; i < std::min(prefetchDistance, uidList.size()); ++i)
+            __builtin_prefetch(&m_table[hash(uidList[i]) & m_mask]);
+        for (std::size_t i{0}; i < uidList.size(); ++i) {
+            if (i + prefetchDistance < uidList.size())
+                __builtin_prefetch(&m_table[hash(uidList[i + prefetchDistance]) & m_mask]);
+            const auto& entry = m_table[findPosition(uidList[i])];
+            func(uidList[i], entry.value == emptySlot ? std::nullopt : std::optional<std::size_t>(entry.value));
+        }
+    }
+
+    bool erase(const boost::uuids::uuid& uid) {
+        std::size_t pos = findPosition(uid);
+        if (m_table[pos].value == emptySlot)
+            return false;
+
+        // backward shift: move following entries of the probe sequence into the gap
+        std::size_t next = (pos + 1) & m_mask;
+        while (m_table[next].value != emptySlot) {
+            std::size_t home = hash(m_table[next].key) & m_mask;
+            // is the entry at "next" allowed to be moved to "pos" (cyclic compare)
+            if (((next - home) & m_mask) >= ((next - pos) & m_mask)) {
+                m_table[pos] = m_table[next];
+                pos = next;
+            }
+            next = (next + 1) & m_mask;
+        }
+        m_table[pos].value = emptySlot;
+        --m_size;
+        return true;
+    }
+
+    void clear() {
+        m_table.assign(minCapacity, Entry());
+        m_mask = minCapacity - 1;
+        m_size = 0;
+    }
+
+    std::size_t size() const { return m_size; }
+
+    // the hash table as it is, to be stored in an index file (the positions depend on the hash function)
+    const std::vector<Entry>& table() const { return m_table; }
+
+    // take a stored table, that must only refer to slots below slotCount, unchanged if it is not valid
+    template <typename Table>
+    bool assignTable(const Table& table, std::size_t slotCount) {
+        auto capacity = static_cast<std::size_t>(std::distance(std::begin(table), std::end(table)));
+        if (capacity < minCapacity || (capacity & (capacity - 1)) != 0)
+            return false;
+        std::size_t size {0};
+        for (const auto& entry : table) {
+            if (entry.value == emptySlot)
+                continue;
+            if (entry.value >= slotCount)
+                return false;
+            ++size;
+        }
+        m_table.assign(std::begin(table), std::end(table));
+        m_mask = capacity - 1;
+        m_size = size;
+        return true;
+    }
+
+};
+
+}
+
+#endif // DATABASE_UUIDINDEX_H
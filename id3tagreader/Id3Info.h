@@ -8,6 +8,7 @@
 #include <fstream>
 #include <algorithm>
 #include "common/stringmanipulator.h"
+#include "common/internedstring.h"
 #include "common/filesystemadditions.h"
 #include "common/logger.h"
 #include <boost/uuid/uuid.hpp>
@@ -15,31 +16,33 @@
 #include "idtag.h"
 
 
+// strings repeating over many tracks (album, performer, urls) are interned
 class Id3Info {
 
-    std::string albumName_lower;
+    Common::InternedString albumName_lower;
     std::string titleName_lower;
-    std::string performerName_lower;
+    Common::InternedString performerName_lower;
+    std::vector<Tag> tags;
+    TagMask tagMask {0};
 
 public:
 
     boost::uuids::uuid uid;
-    std::string album_name;
+    Common::InternedString album_name;
     std::string title_name;
-    std::string performer_name;
+    Common::InternedString performer_name;
     uint32_t track_no {0};
     uint32_t all_tracks_no {0};
     uint32_t cd_no {0};
     uint32_t genreId;
-    std::vector<Tag> tags;
     bool albumCreation { true };
 
-    std::string informationSource;
+    Common::InternedString informationSource;
 
-    std::string urlAudioFile;
-    std::string audioFileExt;
-    std::string urlCoverFile;
-    std::string coverFileExt;
+    Common::InternedString urlAudioFile;
+    Common::InternedString audioFileExt;
+    Common::InternedString urlCoverFile;
+    Common::InternedString coverFileExt;
 
     bool operator==(const Id3Info& info) const {
         return album_name == info.album_name &&
@@ -58,17 +61,23 @@ public:
     Id3Info(Id3Info&& info) = default;
 
     bool finishEntry() {
-        albumName_lower = Common::str_tolower(album_name);
-        performerName_lower = Common::str_tolower(performer_name);
-        titleName_lower = Common::str_tolower(title_name);
+        albumName_lower = Common::normalize(album_name.str());
+        performerName_lower = Common::normalize(performer_name.str());
+        titleName_lower = Common::normalize(title_name);
 
         return true;
     }
 
     void setTags(std::vector<Tag>&& tagList) {
         tags = std::move(tagList);
+        tagMask = TagConverter::getTagMask(tags);
     }
 
+    const std::vector<Tag>& getTags() const { return tags; }
+
+    // position of the track within its album
+    uint32_t getAlbumPosition() const { return cd_no*1000 + track_no; }
+
     Id3Info& operator=(const Id3Info& info) = default;
     Id3Info& operator=(Id3Info&& info) = default;
 
@@ -106,31 +115,24 @@ public:
     }
 
     bool isAlikeTag(const std::vector<std::string>& whatList) const {
-        for (auto& part : whatList) {
-            std::string tagName = Common::str_tolower(part);
-
-            auto tag = TagConverter::getTagIdAlike(tagName);
+        return hasAnyTag(TagConverter::getTagMaskAlike(whatList));
+    }
 
-            if (tag != Tag::unknown) {
-                if (std::find_if(std::begin(tags), std::end(tags),
-                                 [&tag](const Tag& elem) { return elem == tag; }
-                                 ) != std::end(tags))
-                    return true;
-            }
-        }
-        return false;
+    // mask resolved from the request by TagConverter::getTagMaskAlike
+    bool hasAnyTag(TagMask mask) const {
+        return (tagMask & mask) != 0;
     }
 
-    std::string getNormalizedAlbum() const {
-        return albumName_lower;
+    const std::string& getNormalizedAlbum() const {
+        return albumName_lower.str();
     }
 
-    std::string getNormalizedTitle() const {
+    const std::string& getNormalizedTitle() const {
         return titleName_lower;
     }
 
-    std::string getNormalizedPerformer() const {
-        return performerName_lower;
+    const std::string& getNormalizedPerformer() const {
+        return performerName_lower.str();
     }
 };
 
@@ -71,7 +71,7 @@ std::optional<FullId3Information> id3TagReader::readJsonAudioInfo(const Common::
                 fullInfo.data = std::move(cover);
                 info.urlCoverFile =
                         Common::FileSystemAdditions::getFullQualifiedDirectory(Common::FileType::CoversRelative) +
-                        "/" + boost::uuids::to_string(info.uid) + info.coverFileExt;
+                        "/" + boost::uuids::to_string(info.uid) + info.coverFileExt.str();
             }
             else {
                 if (streamInfo.find(ServerConstant::JsonField::imageUrl) != streamInfo.end()) {
@@ -180,7 +180,7 @@ std::optional<FullId3Information> id3TagReader::readMp3AudioInfo(const Common::F
 
                     // assume image is set correctly (later)
                     fullId3Info.info.urlCoverFile = std::string(ServerConstant::coverPathWeb) + "/"
-                            + boost::lexical_cast<std::string>(uid) + fullId3Info.info.coverFileExt;
+                            + boost::lexical_cast<std::string>(uid) + fullId3Info.info.coverFileExt.str();
 
                     logger(Level::debug) << "image found for <" << fullId3Info.info.toString() << ">\n";
                 }
@@ -298,7 +298,7 @@ std::optional<FullId3Information> id3TagReader::readMp3AudioInfo(const Common::F
 
                     // assume image is set correctly (later)
                     fullId3Info.info.urlCoverFile = std::string(ServerConstant::coverPathWeb) + "/"
-                            + boost::lexical_cast<std::string>(uid) + fullId3Info.info.coverFileExt;
+                            + boost::lexical_cast<std::string>(uid) + fullId3Info.info.coverFileExt.str();
 
                     logger(Level::debug) << "image found for <" << fullId3Info.info.toString() << ">\n";
                 }
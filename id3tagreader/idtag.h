@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <algorithm>
+#include <cstdint>
 #include "common/logger.h"
 #include "common/stringmanipulator.h"
 
@@ -19,6 +21,9 @@ enum class Tag {
     unknown
 };
 
+// one bit per tag, so a tag list is matched against a request with a single AND
+using TagMask = uint32_t;
+
 class TagConverter {
 public:
     struct TagIdentifierElem {
@@ -56,6 +61,27 @@ public:
         return Tag::unknown;
     }
 
+    static TagMask getTagMask(Tag tag) {
+        if (tag == Tag::unknown)
+            return 0;
+        return TagMask(1) << static_cast<unsigned>(tag);
+    }
+
+    static TagMask getTagMask(const std::vector<Tag>& tagList) {
+        TagMask mask {0};
+        for (const auto& tag : tagList)
+            mask |= getTagMask(tag);
+        return mask;
+    }
+
+    // resolve all words of a search request to the known tags, done once per request
+    static TagMask getTagMaskAlike(const std::vector<std::string>& whatList) {
+        TagMask mask {0};
+        for (const auto& what : whatList)
+            mask |= getTagMask(getTagIdAlike(what));
+        return mask;
+    }
+
     static std::string getTagName(const std::vector<Tag>& tagList) {
         std::stringstream allString;
         for (const auto& id : tagList) {
@@ -193,6 +193,10 @@ void BasePlayer::setSongEndCB(SongEndCallback&& endfunc) {
     m_songEndCallback = std::move(endfunc);
 }
 
+void BasePlayer::setSongPlayedCB(SongPlayedCallback&& playedfunc) {
+    m_songPlayedCallback = std::move(playedfunc);
+}
+
 void BasePlayer::resetPlayer() {
 
     m_shuffle = false;
@@ -15,6 +15,8 @@
 
 using PlaylistEndCallback = std::function<void()>;
 using SongEndCallback = std::function<void(const boost::uuids::uuid&)>;
+// called only when a song is played up to its end (not on skips)
+using SongPlayedCallback = std::function<void(const boost::uuids::uuid&)>;
 using OnUiChangeHandler = std::function<void( const boost::uuids::uuid& songID, const boost::uuids::uuid& playlistID, int position, bool doLoop, bool doShuffle)>;
 
 
@@ -24,6 +26,7 @@ protected:
 
     PlaylistEndCallback m_playlistEndCallback;
     SongEndCallback m_songEndCallback;
+    SongPlayedCallback m_songPlayedCallback;
     OnUiChangeHandler m_onUiChangeHandler;
 
     std::vector<Common::PlaylistItem> m_playlist;
@@ -78,6 +81,7 @@ public:
 
     void setPlaylistEndCB(PlaylistEndCallback&& endfunc);
     void setSongEndCB(SongEndCallback&& endfunc);
+    void setSongPlayedCB(SongPlayedCallback&& playedfunc);
 
     void resetPlayer();
 
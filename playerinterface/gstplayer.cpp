@@ -25,6 +25,7 @@ gboolean GstPlayer::_handle_message(GstBus *, GstMessage *msg) {
         // pulling execution into correct context (just in case)
         auto eos_handler = [this]() {
         logger(LoggerFramework::Level::debug) << "End-Of-Stream reached.\n";
+        if (m_songPlayedCallback) m_songPlayedCallback(m_currentItemIterator->m_uniqueId);
         if (m_songEndCallback) m_songEndCallback(m_currentItemIterator->m_uniqueId);
         if (calculateNextFileInList()) {
             doPlayFile(*m_currentItemIterator);
@@ -230,6 +230,10 @@ void MpvPlayer::read_handler(const boost::system::error_code &error, std::size_t
             }
             else if (event == "end-file") {
                 logger(Level::debug) << "End file event found on <" << boost::uuids::to_string(m_currentItemIterator->m_uniqueId) << ">.\n";
+                // skips stop the file, only a file played to its end gives "eof"
+                if (returnData.value("reason", "") == "eof" && m_songPlayedCallback) {
+                    m_songPlayedCallback(m_currentItemIterator->m_uniqueId);
+                }
                     switch (m_nextPlaylistDirection) {
                     case MpvPlayer::NextPlaylistDirection::next: {
                         if (calculateNextFileInList()) {
@@ -0,0 +1,450 @@
+#include <assert.h>
+#include <algorithm>
+#include <sstream>
+#include <random>
+#include <unordered_map>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/functional/hash.hpp>
+#include "common/logger.h"
+#include "common/stringmanipulator.h"
+#include "database/query.h"
+#include "database/resultpage.h"
+#include "database/songtagreader.h"
+#include "database/completionindex.h"
+#include "database/playhistory.h"
+#include "database/indexfile.h"
+#include "database/uuidindex.h"
+#include "database/textcolumn.h"
+#include "webserver/rankedmerge.h"
+
+using namespace Database;
+
+// every record is a set of words, a leaf matches all records containing the word
+QueryBitSet evaluate(const std::string& expression, const std::vector<std::vector<std::string>>& records) {
+    auto query = Query::compile(Common::extractWhatList(expression));
+    assert ( query.has_value() );
+    return query->evaluate(records.size(), [&records](const std::string& word) {
+        QueryBitSet result(records.size());
+        for (std::size_t i{0}; i < records.size(); ++i)
+            if (std::find(std::begin(records[i]), std::end(records[i]), word) != std::end(records[i]))
+                result.set(i);
+        return result;
+    });
+}
+
+std::vector<std::size_t> toList(const QueryBitSet& bitSet) {
+    std::vector<std::size_t> list;
+    bitSet.forEach([&list](std::size_t position) { list.push_back(position); });
+    return list;
+}
+
+int main() {
+
+    const std::vector<std::vector<std::string>> records {
+        { "beatles", "help" },
+        { "beatles", "live" },
+        { "stones", "live" },
+        { "stones", "sticky" },
+        { "doors" }
+    };
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 1: bitset operations\n";
+        QueryBitSet a(130);
+        QueryBitSet b(130);
+        a.set(0); a.set(64); a.set(129);
+        b.set(64); b.set(100);
+        assert ( a.count() == 3 );
+        assert ( a.test(129) && !a.test(128) );
+        QueryBitSet c = a;
+        c &= b;
+        assert ( toList(c) == std::vector<std::size_t>({64}) );
+        c = a;
+        c |= b;
+        assert ( toList(c) == std::vector<std::size_t>({0, 64, 100, 129}) );
+        c.flip();
+        assert ( c.count() == 126 );
+        assert ( QueryBitSet(130, true).count() == 130 );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 2: expression detection\n";
+        assert ( !Query::isExpression({"beatles", "help"}) );
+        assert ( Query::isExpression({"beatles", "&", "help"}) );
+        assert ( Query::isExpression({"(beatles", "|", "stones)"}) );
+        assert ( Query::isExpression({"!live"}) );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 3: infix expressions\n";
+        assert ( toList(evaluate("beatles & live", records)) == std::vector<std::size_t>({1}) );
+        assert ( toList(evaluate("beatles | stones", records)) == std::vector<std::size_t>({0, 1, 2, 3}) );
+        assert ( toList(evaluate("!live", records)) == std::vector<std::size_t>({0, 3, 4}) );
+        assert ( toList(evaluate("(beatles | stones) & !live", records)) == std::vector<std::size_t>({0, 3}) );
+        assert ( toList(evaluate("doors | stones & live", records)) == std::vector<std::size_t>({2, 4}) );
+        assert ( toList(evaluate("!(beatles | stones)", records)) == std::vector<std::size_t>({4}) );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 4: postfix expressions\n";
+        assert ( toList(evaluate("beatles live &", records)) == std::vector<std::size_t>({1}) );
+        assert ( toList(evaluate("beatles stones | live &", records)) == std::vector<std::size_t>({1, 2}) );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 5: malformed expressions\n";
+        assert ( !Query::compile({"beatles", "&"}).has_value() );
+        assert ( !Query::compile({"(beatles", "|", "stones"}).has_value() );
+        assert ( !Query::compile({"beatles", "stones"}).has_value() );
+        assert ( !Query::compile({"&", "|"}).has_value() );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 6: result pages\n";
+        QueryBitSet result(10);
+        for (auto row : {1, 2, 4, 5, 7, 9})
+            result.set(row);
+
+        std::vector<std::size_t> page;
+        auto take = [&page](std::size_t row) { page.push_back(row); };
+
+        // storage order
+        auto next = Page::byRow(result, PageRequest{4, 0, SortOrder::unsorted}, take);
+        assert ( page == std::vector<std::size_t>({1, 2, 4, 5}) && next );
+        page.clear();
+        next = Page::byRow(result, PageRequest{4, *next, SortOrder::unsorted}, take);
+        assert ( page == std::vector<std::size_t>({7, 9}) && !next );
+
+        // precomputed order (reverse)
+        auto order = buildOrder(result.size(), [](uint32_t row1, uint32_t row2) { return row1 > row2; });
+        page.clear();
+        next = Page::byOrder(order, result, PageRequest{3, 0, SortOrder::name}, take);
+        assert ( page == std::vector<std::size_t>({9, 7, 5}) && next );
+        page.clear();
+        next = Page::byOrder(order, result, PageRequest{3, *next, SortOrder::name}, take);
+        assert ( page == std::vector<std::size_t>({4, 2, 1}) && !next );
+
+        // top k by score, storage order on equal score
+        auto score = [](std::size_t row) { return static_cast<int>(row % 3); };
+        page.clear();
+        next = Page::byScore(result, PageRequest{2, 0, SortOrder::relevance}, score, take);
+        assert ( page == std::vector<std::size_t>({2, 5}) && next && *next == 2 );
+        page.clear();
+        next = Page::byScore(result, PageRequest{2, *next, SortOrder::relevance}, score, take);
+        assert ( page == std::vector<std::size_t>({1, 4}) && next );
+        page.clear();
+        next = Page::byScore(result, PageRequest{0, 0, SortOrder::relevance}, score, take);
+        assert ( page == std::vector<std::size_t>({2, 5, 1, 4, 7, 9}) && !next );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 7: search key normalization\n";
+        assert ( Common::normalize("The BEATLES") == "the beatles" );
+        assert ( Common::normalize("Björk") == Common::normalize("BJÖRK") );
+        assert ( Common::normalize("Björk") == "bjork" );
+        assert ( Common::normalize("Mötley Crüe – Straße") == "motley crue – strasse" );
+        assert ( Common::normalize("Bjo\xcc\x88rk") == "bjork" ); // decomposed umlaut
+        assert ( Common::normalize("ΑΒΓ Ωδή") == "αβγ ωδη" );
+        assert ( Common::normalize("КИНО") == "кино" );
+        assert ( Common::normalize("a\xff") == "a\xff" ); // no utf-8
+        assert ( Common::extractWhatList("SIGUR Rós") == std::vector<std::string>({"sigur", "ros"}) );
+        assert ( evaluate("BEATLES & Hélp", records).count() == 1 );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 8: tag file identifiers are normalized\n";
+        std::istringstream tagFile("# comment\n"
+                                   "The BEATLES | rock\n"
+                                   "Björk : Debut | pop\n"
+                                   "björk:DEBUT:Human Behaviour | jazz\n");
+        SongTagReader songTagReader;
+        songTagReader.readSongTagList(tagFile);
+        // stored names are normalized
+        assert ( songTagReader.findSongTagList("help", "yesterday", "the beatles") == std::vector<Tag>({Tag::Rock}) );
+        assert ( songTagReader.findSongTagList("debut", "human behaviour", "bjork") == std::vector<Tag>({Tag::Jazz, Tag::Pop}) );
+        assert ( songTagReader.findSongTagList("post", "army of me", "bjork").empty() );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 9: word completion\n";
+        CompletionIndex index;
+        index.addText("the beatles");
+        index.addText("beat it");
+        index.addText("the beat goes on");
+        index.addText("beatles for sale");
+        index.addText("sale of the century");
+        index.seal();
+
+        assert ( index.size() == 10 );
+
+        CompletionIndex::State state;
+        auto wordList = index.complete("b", state);
+        assert ( wordList.size() == 2 );
+        assert ( wordList[0] == "beat" );
+        assert ( wordList[1] == "beatles" );
+
+        // refined within the range of "b"
+        auto range = state.range;
+        wordList = index.complete("beatl", state);
+        assert ( state.range.begin >= range.begin && state.range.end <= range.end );
+        assert ( wordList.size() == 1 && wordList[0] == "beatles" );
+
+        // not an extension, starts over
+        wordList = index.complete("th", state);
+        assert ( wordList.size() == 1 && wordList[0] == "the" );
+
+        // most frequent first
+        wordList = index.complete("", state);
+        assert ( wordList.size() == 10 );
+        assert ( wordList[0] == "the" );
+
+        wordList = index.complete("x", state);
+        assert ( wordList.empty() );
+
+        // a rebuild invalidates the session range
+        index.clear();
+        index.addText("xylophone");
+        index.seal();
+        wordList = index.complete("xy", state);
+        assert ( wordList.size() == 1 && wordList[0] == "xylophone" );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 10: play history\n";
+        auto historyFile = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        boost::uuids::random_generator generator;
+        auto uid1 = generator(), uid2 = generator(), uid3 = generator();
+
+        {
+            PlayHistory history(historyFile, 4);
+            assert ( history.read() );
+            history.add(uid1, 1);
+            history.add(uid2, 2);
+            history.add(uid1, 3);
+            // buffered until the buffer is full
+            assert ( history.pending() == 3 && !boost::filesystem::exists(historyFile) );
+            history.add(uid3, 4);
+            assert ( history.pending() == 0 && boost::filesystem::exists(historyFile) );
+            history.add(uid2, 5);
+            history.add(uid2, 6);
+            auto mostPlayed = history.mostPlayed(2);
+            assert ( mostPlayed.size() == 2 && mostPlayed[0].uid == uid2 && mostPlayed[0].playCount == 3 );
+            assert ( mostPlayed[1].uid == uid1 && mostPlayed[1].playCount == 2 );
+            auto recentlyPlayed = history.recentlyPlayed(10);
+            assert ( recentlyPlayed.size() == 3 && recentlyPlayed[0].uid == uid2 && recentlyPlayed[1].uid == uid3 );
+            assert ( recentlyPlayed[2].uid == uid1 && recentlyPlayed[2].lastPlayed == 3 );
+        }
+
+        // a torn last record is cut, the next plays are appended behind the last complete one
+        auto validSize = boost::filesystem::file_size(historyFile);
+        {
+            std::ofstream ofs(historyFile, std::ios::app | std::ios::binary);
+            ofs << "xyz";
+        }
+        {
+            PlayHistory history(historyFile, 4);
+            assert ( history.read() && history.playCount() == 6 );
+            assert ( boost::filesystem::file_size(historyFile) == validSize );
+            history.add(uid3, 7);
+            assert ( history.flush() );
+        }
+        {
+            PlayHistory history(historyFile);
+            assert ( history.read() && history.playCount() == 7 );
+            assert ( history.recentlyPlayed(1)[0].uid == uid3 && history.mostPlayed(10).size() == 3 );
+        }
+
+        // a file of another format is moved aside
+        {
+            std::ofstream ofs(historyFile, std::ios::trunc);
+            ofs << "garbage!garbage!";
+        }
+        {
+            PlayHistory history(historyFile);
+            assert ( !history.read() && history.playCount() == 0 );
+            assert ( !boost::filesystem::exists(historyFile) && boost::filesystem::exists(historyFile + ".invalid") );
+        }
+        boost::filesystem::remove(historyFile + ".invalid");
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 11: index file\n";
+        auto indexFile = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        constexpr uint64_t contentChecksum { 0x1234 };
+        boost::uuids::random_generator generator;
+        std::vector<boost::uuids::uuid> uidList { generator(), generator(), generator() };
+
+        UuidIndex uidIndex;
+        for (std::size_t slot{0}; slot < uidList.size(); ++slot)
+            uidIndex.insert(uidList[slot], slot);
+        std::vector<uint32_t> order { 2, 0, 1 };
+
+        IndexFile::Writer writer;
+        writer.add(1, uidIndex.table());
+        writer.add(2, order);
+        assert ( writer.write(indexFile, contentChecksum) );
+
+        {
+            auto reader = IndexFile::Reader::open(indexFile, contentChecksum);
+            assert ( reader );
+            auto orderSection = reader->section<uint32_t>(2);
+            assert ( orderSection && std::vector<uint32_t>(std::begin(*orderSection), std::end(*orderSection)) == order );
+            // unknown section or another element size
+            assert ( !reader->section<uint32_t>(3) && !reader->section<uint64_t>(2) );
+
+            auto tableSection = reader->section<UuidIndex::Entry>(1);
+            assert ( tableSection && tableSection->size == uidIndex.table().size() );
+            UuidIndex restoredIndex;
+            // a table referring to a slot behind the rows is rejected
+            assert ( !restoredIndex.assignTable(*tableSection, uidList.size() - 1) && restoredIndex.size() == 0 );
+            assert ( restoredIndex.assignTable(*tableSection, uidList.size()) && restoredIndex.size() == uidList.size() );
+            for (std::size_t slot{0}; slot < uidList.size(); ++slot)
+                assert ( restoredIndex.find(uidList[slot]) == slot );
+        }
+
+        // built for other content
+        assert ( !IndexFile::Reader::open(indexFile, contentChecksum + 1) );
+
+        // a changed byte of the payload
+        {
+            std::fstream fs(indexFile, std::ios::in | std::ios::out | std::ios::binary);
+            fs.seekg(-1, std::ios::end);
+            char last = static_cast<char>(fs.get());
+            fs.seekp(-1, std::ios::end);
+            fs.put(static_cast<char>(last ^ 0x01));
+        }
+        assert ( !IndexFile::Reader::open(indexFile, contentChecksum) );
+
+        boost::filesystem::remove(indexFile);
+        assert ( !IndexFile::Reader::open(indexFile, contentChecksum) );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 12: merge of federated results\n";
+        namespace JsonField = ServerConstant::JsonField;
+        auto album = [](const std::string& uid, const std::string& peer) {
+            nlohmann::json item { {JsonField::uid, uid}, {JsonField::album, "Help"} };
+            if (!peer.empty())
+                item[JsonField::peer] = peer;
+            return item;
+        };
+        auto audioItem = [](const std::string& uid, const std::string& peer) {
+            nlohmann::json item { {JsonField::uid, uid}, {JsonField::audioUrl, "/audio/" + uid + ".mp3"} };
+            if (!peer.empty())
+                item[JsonField::peer] = peer;
+            return item;
+        };
+
+        // two instances with an album of the same name (same uid), the track is on both
+        RankedMerge merge;
+        merge.add(nlohmann::json::array({ album("a1", ""), audioItem("t1", ""), album("a2", "") }));
+        merge.add(nlohmann::json::array({ album("a1", "peer:8080"), audioItem("t1", "peer:8080") }));
+        merge.add(nlohmann::json::array({ album("a1", "peer:8080") }));
+
+        auto list = merge.list();
+        auto peerOf = [](const nlohmann::json& item) { return item.value(JsonField::peer, std::string()); };
+        assert ( list.size() == 4 );
+        assert ( list[0][JsonField::uid] == "a1" && peerOf(list[0]).empty() );
+        assert ( list[1][JsonField::uid] == "a1" && peerOf(list[1]) == "peer:8080" );
+        assert ( list[2][JsonField::uid] == "t1" && peerOf(list[2]).empty() );
+        assert ( list[3][JsonField::uid] == "a2" );
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 13: uuid index with inserts and erases\n";
+        boost::uuids::random_generator generator;
+        std::mt19937 random(13);
+        std::vector<boost::uuids::uuid> uidList;
+        for (std::size_t i{0}; i < 2000; ++i)
+            uidList.push_back(generator());
+
+        UuidIndex uidIndex;
+        std::unordered_map<boost::uuids::uuid, std::size_t, boost::hash<boost::uuids::uuid>> reference;
+        for (std::size_t step{0}; step < 20000; ++step) {
+            const auto& uid = uidList[random() % uidList.size()];
+            // more inserts than erases first, so the table grows and holds long probe sequences
+            if (random() % 10 < (step < 10000 ? 6u : 4u)) {
+                uidIndex.insert(uid, step);
+                reference[uid] = step;
+            }
+            else {
+                assert ( uidIndex.erase(uid) == (reference.erase(uid) == 1) );
+            }
+
+            if (step % 1000 == 999) {
+                assert ( uidIndex.size() == reference.size() );
+                for (const auto& key : uidList) {
+                    auto entry = reference.find(key);
+                    auto slot = uidIndex.find(key);
+                    assert ( entry == std::end(reference) ? !slot : (slot && *slot == entry->second) );
+                }
+            }
+        }
+    }
+
+    {
+        logger(LoggerFramework::Level::info) << "Test 14: text column scan implementations\n";
+        std::vector<TextColumn::Implementation> implementationList { TextColumn::Implementation::scalar };
+        if (TextColumn::bestImplementation() != TextColumn::Implementation::scalar)
+            implementationList.push_back(TextColumn::Implementation::sse2);
+        if (TextColumn::bestImplementation() == TextColumn::Implementation::avx2)
+            implementationList.push_back(TextColumn::Implementation::avx2);
+
+        // all implementations give the same rows
+        auto findAny = [&implementationList](const TextColumn& column, const std::vector<std::string>& needleList) {
+            std::vector<std::size_t> rowList;
+            for (auto implementation : implementationList) {
+                QueryBitSet result(column.rows());
+                column.findAny(needleList, result, implementation);
+                if (implementation == TextColumn::Implementation::scalar)
+                    rowList = toList(result);
+                assert ( toList(result) == rowList );
+            }
+            return rowList;
+        };
+
+        // rows long enough for several vector blocks, the needle at the end of a row and of the blob
+        TextColumn column;
+        column.append(std::string(40, 'x') + "abc");
+        column.append("c" + std::string(70, 'y'));
+        column.append(std::string(33, 'x') + "ab");
+        column.append("cde");
+        column.append(std::string(100, 'z') + "abc");
+        assert ( findAny(column, {"abc"}) == std::vector<std::size_t>({0, 4}) );
+        // not found across the end of a row
+        assert ( findAny(column, {"abc", "bcd"}) == std::vector<std::size_t>({0, 4}) );
+        assert ( findAny(column, {"c"}) == std::vector<std::size_t>({0, 1, 3, 4}) );
+        assert ( findAny(column, {"zabc", "xab"}) == std::vector<std::size_t>({0, 2, 4}) );
+        assert ( findAny(column, {std::string(100, 'z') + "abc"}) == std::vector<std::size_t>({4}) );
+        assert ( findAny(column, {"q"}).empty() );
+
+        // random rows of a small alphabet, so there are many partial matches
+        std::mt19937 random(14);
+        auto word = [&random](std::size_t maxLength) {
+            std::string text(random() % (maxLength + 1), ' ');
+            for (auto& c : text)
+                c = static_cast<char>('a' + random() % 3);
+            return text;
+        };
+        for (std::size_t round{0}; round < 50; ++round) {
+            TextColumn randomColumn;
+            std::vector<std::string> rowList;
+            for (std::size_t row{0}; row < 1 + random() % 60; ++row) {
+                rowList.push_back(word(50));
+                randomColumn.append(rowList.back());
+            }
+            std::vector<std::string> needleList { word(5) + "a", word(8) + "b" };
+            std::vector<std::size_t> expected;
+            for (std::size_t row{0}; row < rowList.size(); ++row) {
+                if (std::any_of(std::begin(needleList), std::end(needleList),
+                                [&](const std::string& needle) { return rowList[row].find(needle) != std::string::npos; }))
+                    expected.push_back(row);
+            }
+            assert ( findAny(randomColumn, needleList) == expected );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -219,25 +219,26 @@ void Session::on_read_header(std::shared_ptr<http::request_parser<http::empty_bo
                 logger(Level::debug) << "<" << m_runID << "> " << "finished read on target <" << requestString->get().target() << ">\n";
                 boost::ignore_unused(ec, bytes_transferred);
 
-                // find if this is a rest request, run the handler
-                auto reply = m_sessionHandler.callHandler(*requestString);
-
-                // if not a rest request, try find the file
-                if (reply.empty()) {
-                    logger(Level::debug) << "no reply set - answer with status <not found>\n";
-                    answer(generate_result_packet(http::status::not_found,
-                                                  requestString->get().target(),
-                                                  requestString->get().version(),
-                                                  requestString->get().keep_alive()));
-                }
-                else {
-                    logger(Level::debug) << "reply set - answer with status <ok>\n";
-                    answer(generate_result_packet(http::status::ok,
-                                                  reply,
-                                                  requestString->get().version(),
-                                                  requestString->get().keep_alive()));
-
-                }
+                // find if this is a rest request, run the handler (it may reply later)
+                m_sessionHandler.callHandler(*requestString, [this, self, requestString](std::string&& reply) {
+
+                    // if not a rest request, try find the file
+                    if (reply.empty()) {
+                        logger(Level::debug) << "no reply set - answer with status <not found>\n";
+                        answer(generate_result_packet(http::status::not_found,
+                                                      requestString->get().target(),
+                                                      requestString->get().version(),
+                                                      requestString->get().keep_alive()));
+                    }
+                    else {
+                        logger(Level::debug) << "reply set - answer with status <ok>\n";
+                        answer(generate_result_packet(http::status::ok,
+                                                      reply,
+                                                      requestString->get().version(),
+                                                      requestString->get().keep_alive()));
+
+                    }
+                });
 
             }
         });
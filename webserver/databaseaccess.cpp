@@ -5,42 +5,46 @@
 
 using namespace LoggerFramework;
 
-std::string DatabaseAccess::convertToJson(const std::optional<std::vector<Id3Info>> list) {
-
-    nlohmann::json json;
-    if (list) {
-        if (list->empty()){
-            return R"([])";
-        }
-        for(auto item : list.value()) {
-            nlohmann::json jentry;
-            std::string urlAudioFile {item.urlAudioFile};
-            if (item.urlAudioFile.length() > ServerConstant::fileprefix.length() &&
-                    item.urlAudioFile.substr(0,ServerConstant::fileprefix.length()) == ServerConstant::fileprefix) {
-                std::string extension = std::string(ServerConstant::mp3Extension); // default use mp3
-                if (auto dotPos = item.urlAudioFile.find_last_of('.')) {
-                    extension = item.urlAudioFile.substr(dotPos);
-                }
-                urlAudioFile = std::string(ServerConstant::audioPath) + "/" + boost::uuids::to_string(item.uid) + extension;
-            }
-            jentry[ServerConstant::JsonField::uid] = boost::uuids::to_string(item.uid);
-            jentry[ServerConstant::JsonField::performer] = item.performer_name;
-            jentry[ServerConstant::JsonField::album] = item.album_name;
-            jentry[ServerConstant::JsonField::title] = item.title_name;
-            jentry[ServerConstant::JsonField::imageUrl] = item.urlCoverFile;
-            jentry[ServerConstant::JsonField::trackNo] = item.track_no;
-            jentry[ServerConstant::JsonField::audioUrl] = urlAudioFile;
-            json.push_back(jentry);
+namespace {
+
+nlohmann::json toJson(const Id3Info& item) {
+    nlohmann::json jentry;
+    std::string urlAudioFile {item.urlAudioFile};
+    if (item.urlAudioFile.length() > ServerConstant::fileprefix.length() &&
+            item.urlAudioFile.substr(0,ServerConstant::fileprefix.length()) == ServerConstant::fileprefix) {
+        std::string extension = std::string(ServerConstant::mp3Extension); // default use mp3
+        if (auto dotPos = item.urlAudioFile.find_last_of('.')) {
+            extension = item.urlAudioFile.substr(dotPos);
         }
+        urlAudioFile = std::string(ServerConstant::audioPath) + "/" + boost::uuids::to_string(item.uid) + extension;
     }
-    else {
+    jentry[ServerConstant::JsonField::uid] = boost::uuids::to_string(item.uid);
+    jentry[ServerConstant::JsonField::performer] = item.performer_name;
+    jentry[ServerConstant::JsonField::album] = item.album_name;
+    jentry[ServerConstant::JsonField::title] = item.title_name;
+    jentry[ServerConstant::JsonField::imageUrl] = item.urlCoverFile;
+    jentry[ServerConstant::JsonField::trackNo] = item.track_no;
+    jentry[ServerConstant::JsonField::audioUrl] = urlAudioFile;
+    return jentry;
+}
+
+}
+
+std::string DatabaseAccess::convertToJson(const Database::ResultList<Id3Info>& list) {
+
+    nlohmann::json json;
+    if (list.empty()){
         return R"([])";
     }
+    for(const auto& item : list) {
+        json.push_back(toJson(item));
+    }
+
     //logger(Level::info) << json.dump(2)<<"\n";
     return json.dump(2);
 }
 
-std::string DatabaseAccess::convertToJson(const std::vector<Database::Playlist>& list) {
+std::string DatabaseAccess::convertToJson(const Database::ResultList<Database::Playlist>& list) {
 
     nlohmann::json json;
 
@@ -48,7 +52,7 @@ std::string DatabaseAccess::convertToJson(const std::vector<Database::Playlist>&
         if (list.empty()) {
             return R"([])";
         }
-        for(auto item : list) {
+        for(const auto& item : list) {
             nlohmann::json jentry;
             jentry[ServerConstant::JsonField::uid] = boost::uuids::to_string(item.getUniqueID());
             jentry[ServerConstant::JsonField::album] = item.getName();
@@ -59,7 +63,7 @@ std::string DatabaseAccess::convertToJson(const std::vector<Database::Playlist>&
             jentry[ServerConstant::JsonField::trackNo] = 0;
             jentry[ServerConstant::JsonField::url] = "";
 
-            json.push_back(jentry);
+            json.push_back(std::move(jentry));
         }
 
     } catch (const nlohmann::json::exception& ex) {
@@ -84,43 +88,391 @@ std::optional<std::string> DatabaseAccess::extractUuidFromTarget(std::string_vie
     return std::nullopt;
 }
 
+Database::SearchItem DatabaseAccess::toSearchItem(std::string_view parameter) {
+    if (parameter == ServerConstant::Parameter::Database::overall)
+        return Database::SearchItem::overall;
+    if (parameter == ServerConstant::Parameter::Database::performer)
+        return Database::SearchItem::performer;
+    if (parameter == ServerConstant::Parameter::Database::title)
+        return Database::SearchItem::title;
+    if (parameter == ServerConstant::Parameter::Database::album)
+        return Database::SearchItem::album;
+    return Database::SearchItem::unknown;
+}
+
+bool DatabaseAccess::isPageParameter(std::string_view parameter) {
+    return parameter == ServerConstant::Parameter::Database::limit ||
+            parameter == ServerConstant::Parameter::Database::cursor ||
+            parameter == ServerConstant::Parameter::Database::sort;
+}
+
+bool DatabaseAccess::isFederated(const utility::Extractor::UrlInformation &urlInfo) {
+
+    if (!urlInfo || !urlInfo->m_parsed || urlInfo->m_parameterList.empty())
+        return false;
+
+    const auto& parameterList = urlInfo->m_parameterList;
+    if (parameterList.size() == 1 && parameterList.front().name == ServerConstant::Command::getAlbumList)
+        return true;
+
+    return std::all_of(std::begin(parameterList), std::end(parameterList),
+                       [](const utility::Parameter& parameter) { return toSearchItem(parameter.name) != Database::SearchItem::unknown; });
+}
+
+std::optional<Database::PageRequest> DatabaseAccess::toPageRequest(const utility::Extractor::UrlInformation &urlInfo, Database::SortOrder defaultOrder) {
+
+    namespace Parameter = ServerConstant::Parameter::Database;
+    namespace Sort = ServerConstant::Value::Sort;
+
+    if (!urlInfo->hasParameter(Parameter::limit) && !urlInfo->hasParameter(Parameter::cursor) && !urlInfo->hasParameter(Parameter::sort))
+        return std::nullopt;
+
+    Database::PageRequest page;
+    page.order = defaultOrder;
+
+    try {
+        if (urlInfo->hasParameter(Parameter::limit))
+            page.limit = std::stoul(std::string(urlInfo->getValueOfParameter(Parameter::limit)));
+        if (urlInfo->hasParameter(Parameter::cursor))
+            page.cursor = std::stoul(std::string(urlInfo->getValueOfParameter(Parameter::cursor)));
+    } catch (std::exception& ex) {
+        logger(Level::warning) << "invalid limit or cursor given: " << ex.what() << "\n";
+    }
+
+    auto sort = urlInfo->getValueOfParameter(Parameter::sort);
+    if (sort == Sort::relevance)
+        page.order = Database::SortOrder::relevance;
+    else if (sort == Sort::name)
+        page.order = Database::SortOrder::name;
+    else if (sort == Sort::performer)
+        page.order = Database::SortOrder::performer;
+    else if (sort == Sort::added)
+        page.order = Database::SortOrder::added;
+    else if (!sort.empty())
+        logger(Level::warning) << "unknown sort order <" << sort << ">\n";
+
+    return page;
+}
+
+std::string DatabaseAccess::toPageJson(const std::string &listJson, std::optional<std::size_t> nextCursor) {
+    std::string cursor { nextCursor ? std::to_string(*nextCursor) : "null" };
+    return R"({"items": )" + listJson + R"(, "cursor": )" + cursor + "}";
+}
+
+std::string DatabaseAccess::complete(const utility::Extractor::UrlInformation &urlInfo) {
+
+    std::string text { urlInfo->getValueOfParameter(ServerConstant::Parameter::Database::complete) };
+    std::string sessionId { urlInfo->getValueOfParameter(ServerConstant::Parameter::Database::session) };
+
+    // only the word currently typed is completed
+    auto prefix = text.substr(text.find_last_of(' ') + 1);
+
+    // the state is changed by the completion, so the lock is held until it is done
+    std::lock_guard<std::mutex> lock(m_completionSessions->mutex);
+    auto& stateList = m_completionSessions->stateList;
+
+    Database::CompletionIndex::State noSession;
+    if (!sessionId.empty() && stateList.size() >= maxCompletionSessions &&
+            stateList.find(sessionId) == std::end(stateList)) {
+        logger(Level::debug) << "too many completion sessions, dropping all\n";
+        stateList.clear();
+    }
+    auto& state = sessionId.empty() ? noSession : stateList[sessionId];
+
+    auto wordList = getDatabase()->completeWords(prefix, state);
+
+    logger(Level::debug) << "completion of <"<<prefix<<"> gives <"<<wordList.size()<<"> words (range of <"<<state.range.size()<<">)\n";
+
+    nlohmann::json json = nlohmann::json::array();
+    for (auto& word : wordList)
+        json.push_back(std::move(word));
+
+    return json.dump(2);
+}
+
+std::shared_ptr<const DatabaseAccess::DuplicateList> DatabaseAccess::duplicateReport(const Database::SimpleDatabase &database, Database::DuplicateKey key) {
+
+    auto generation = database.generation();
+
+    // the lock is held while searching, so a report is created only once
+    std::lock_guard<std::mutex> lock(m_duplicateReports->mutex);
+    if (generation > m_duplicateReports->generation) {
+        m_duplicateReports->reportList.clear();
+        m_duplicateReports->generation = generation;
+    }
+
+    if (generation == m_duplicateReports->generation) {
+        auto& report = m_duplicateReports->reportList[key];
+        if (!report)
+            report = std::make_shared<const DuplicateList>(database.findDuplicates(key));
+        return report;
+    }
+
+    // an outdated version is not cached
+    return std::make_shared<const DuplicateList>(database.findDuplicates(key));
+}
+
+std::string DatabaseAccess::duplicates(const Database::SimpleDatabase &database, const utility::Extractor::UrlInformation &urlInfo) {
+
+    auto keyName = urlInfo->getValueOfParameter(ServerConstant::Parameter::Database::duplicates);
+    auto key = Database::DuplicateKey::tags;
+    if (keyName == ServerConstant::Value::Duplicates::content)
+        key = Database::DuplicateKey::content;
+    else if (!keyName.empty() && keyName != ServerConstant::Value::Duplicates::tags)
+        logger(Level::warning) << "unknown duplicate key <" << keyName << ">, using tags\n";
+
+    auto page = toPageRequest(urlInfo).value_or(Database::PageRequest{defaultDuplicatesLimit, 0, Database::SortOrder::unsorted});
+
+    auto report = duplicateReport(database, key);
+    const auto& duplicateList = *report;
+
+    nlohmann::json json = nlohmann::json::array();
+    auto end = page.limit ? std::min(duplicateList.size(), page.cursor + page.limit) : duplicateList.size();
+    for (auto position = page.cursor; position < end; ++position) {
+        const auto& [info, uidList] = duplicateList[position];
+        nlohmann::json jentry;
+        jentry[ServerConstant::JsonField::uid] = boost::uuids::to_string(info.uid);
+        jentry[ServerConstant::JsonField::performer] = info.performer_name;
+        jentry[ServerConstant::JsonField::album] = info.album_name;
+        jentry[ServerConstant::JsonField::title] = info.title_name;
+        nlohmann::json duplicateUidList = nlohmann::json::array();
+        for (const auto& uid : uidList)
+            duplicateUidList.push_back(boost::uuids::to_string(uid));
+        jentry[ServerConstant::JsonField::uidList] = std::move(duplicateUidList);
+        json.push_back(std::move(jentry));
+    }
+
+    std::optional<std::size_t> nextCursor;
+    if (end < duplicateList.size())
+        nextCursor = end;
+
+    return toPageJson(json.dump(2), nextCursor);
+}
+
+std::string DatabaseAccess::facets(const Database::SimpleDatabase &database, const utility::Extractor::UrlInformation &urlInfo) {
+
+    namespace Facets = ServerConstant::Value::Facets;
+
+    auto facetName = urlInfo->getValueOfParameter(ServerConstant::Parameter::Database::facets);
+    if (!facetName.empty() && facetName != Facets::performer && facetName != Facets::album && facetName != Facets::tag) {
+        logger(Level::warning) << "unknown facet <" << facetName << ">\n";
+        return R"({"result": "illegal url given" })";
+    }
+
+    auto toJson = [](const std::vector<Database::LibraryFacets::Entry>& entryList, const std::string& groupField) {
+        nlohmann::json json = nlohmann::json::array();
+        for (const auto& entry : entryList) {
+            nlohmann::json jentry;
+            jentry[ServerConstant::JsonField::name] = entry.name;
+            jentry[ServerConstant::JsonField::tracks] = entry.trackCount;
+            jentry[groupField] = entry.groupCount;
+            json.push_back(std::move(jentry));
+        }
+        return json;
+    };
+
+    const auto& facets = database.facets();
+
+    nlohmann::json json;
+    if (facetName.empty() || facetName == Facets::performer)
+        json[ServerConstant::JsonField::performer] = toJson(facets.performers(), ServerConstant::JsonField::albums);
+    if (facetName.empty() || facetName == Facets::album)
+        json[ServerConstant::JsonField::album] = toJson(facets.albums(), ServerConstant::JsonField::performers);
+    if (facetName.empty() || facetName == Facets::tag)
+        json[ServerConstant::JsonField::tag] = toJson(facets.tags(), ServerConstant::JsonField::albums);
+
+    return json.dump(2);
+}
+
+std::string DatabaseAccess::changesSince(const Database::SimpleDatabase &database, const utility::Extractor::UrlInformation &urlInfo) {
+
+    uint64_t generation {0};
+    try {
+        generation = std::stoull(std::string(urlInfo->getValueOfParameter(ServerConstant::Parameter::Database::changesSince)));
+    } catch (std::exception& ex) {
+        logger(Level::warning) << "invalid generation given: " << ex.what() << "\n";
+        return R"({"result": "illegal url given" })";
+    }
+
+    std::string currentGeneration { std::to_string(database.generation()) };
+
+    auto changes = database.changesSince(generation);
+    if (!changes) {
+        logger(Level::debug) << "changes since generation <" << generation << "> are not logged anymore\n";
+        return R"({"generation": )" + currentGeneration + R"(, "resync": true})";
+    }
+
+    auto uidListJson = [](const std::vector<boost::uuids::uuid>& uidList) {
+        nlohmann::json json = nlohmann::json::array();
+        for (const auto& uid : uidList)
+            json.push_back(boost::uuids::to_string(uid));
+        return json.dump(2);
+    };
+
+    auto& [audioChanges, playlistChanges] = *changes;
+    return R"({"generation": )" + currentGeneration + R"(, "resync": false, "items": {"added": )"
+            + convertToJson(database.findAudioItems(audioChanges.added))
+            + R"(, "modified": )" + convertToJson(database.findAudioItems(audioChanges.modified))
+            + R"(, "removed": )" + uidListJson(audioChanges.removed)
+            + R"(}, "playlists": {"added": )" + convertToJson(database.findPlaylistItems(playlistChanges.added))
+            + R"(, "modified": )" + convertToJson(database.findPlaylistItems(playlistChanges.modified))
+            + R"(, "removed": )" + uidListJson(playlistChanges.removed) + "}}";
+}
+
+std::string DatabaseAccess::playedItems(const utility::Extractor::UrlInformation &urlInfo) {
+
+    namespace Parameter = ServerConstant::Parameter::Database;
+
+    bool mostPlayed = urlInfo->hasParameter(Parameter::mostPlayed);
+    auto limitValue = urlInfo->getValueOfParameter(mostPlayed ? Parameter::mostPlayed : Parameter::recentlyPlayed);
+
+    std::size_t limit { defaultPlayedLimit };
+    try {
+        if (!limitValue.empty())
+            limit = std::stoul(std::string(limitValue));
+    } catch (std::exception& ex) {
+        logger(Level::warning) << "invalid number of played items given: " << ex.what() << "\n";
+        return R"({"result": "illegal url given" })";
+    }
+
+    auto entryList = mostPlayed ? m_playHistory->mostPlayed(limit) : m_playHistory->recentlyPlayed(limit);
+
+    std::vector<boost::uuids::uuid> uidList;
+    uidList.reserve(entryList.size());
+    for (const auto& entry : entryList)
+        uidList.push_back(entry.uid);
+
+    // removed audio items are skipped, the others are found in the order of the entry list
+    auto database = getDatabase();
+    auto itemList = database->findAudioItems(uidList);
+
+    nlohmann::json json = nlohmann::json::array();
+    auto item = std::begin(itemList);
+    for (const auto& entry : entryList) {
+        if (item == std::end(itemList))
+            break;
+        if (item->uid != entry.uid)
+            continue;
+        auto jentry = toJson(*item);
+        jentry[ServerConstant::JsonField::playCount] = entry.playCount;
+        jentry[ServerConstant::JsonField::lastPlayed] = entry.lastPlayed;
+        json.push_back(std::move(jentry));
+        ++item;
+    }
+
+    return json.dump(2);
+}
+
 std::string DatabaseAccess::access(const utility::Extractor::UrlInformation &urlInfo) {
 
-    if (!urlInfo || !urlInfo->m_parsed || urlInfo->m_parameterList.size() != 1) {
+    if (!urlInfo || !urlInfo->m_parsed || urlInfo->m_parameterList.empty()) {
         logger(Level::warning) << "invalid url given for database access\n";
         return R"({"result": "illegal url given" })";
     }
 
-    auto& parameter = urlInfo->m_parameterList.at(0).name;
-    auto& value = urlInfo->m_parameterList.at(0).value;
+    if (urlInfo->hasParameter(ServerConstant::Parameter::Database::complete))
+        return complete(urlInfo);
+
+    if (urlInfo->hasParameter(ServerConstant::Parameter::Database::cacheStatistics))
+        return cacheStatistics();
+
+    // the play history changes without a new version of the database
+    if (urlInfo->hasParameter(ServerConstant::Parameter::Database::mostPlayed) ||
+            urlInfo->hasParameter(ServerConstant::Parameter::Database::recentlyPlayed))
+        return playedItems(urlInfo);
+
+    return cachedResponse("database", urlInfo, [this, &urlInfo](const Database::SimpleDatabase& database) {
+        if (urlInfo->hasParameter(ServerConstant::Parameter::Database::duplicates))
+            return duplicates(database, urlInfo);
+        if (urlInfo->hasParameter(ServerConstant::Parameter::Database::facets))
+            return facets(database, urlInfo);
+        if (urlInfo->hasParameter(ServerConstant::Parameter::Database::changesSince))
+            return changesSince(database, urlInfo);
+        return find(database, urlInfo);
+    });
+}
+
+std::string DatabaseAccess::cacheStatistics() {
+    auto statistics = m_responseCache->statistics();
+    nlohmann::json json;
+    json["hits"] = statistics.hits;
+    json["misses"] = statistics.misses;
+    json["entries"] = statistics.entries;
+    json["capacity"] = statistics.capacity;
+    return json.dump(2);
+}
+
+std::string DatabaseAccess::find(const Database::SimpleDatabase &database, const utility::Extractor::UrlInformation &urlInfo) {
+
+    auto page = toPageRequest(urlInfo);
+
+    std::vector<utility::Parameter> parameterList;
+    std::copy_if(std::begin(urlInfo->m_parameterList), std::end(urlInfo->m_parameterList), std::back_inserter(parameterList),
+                 [](const utility::Parameter& parameter) { return !isPageParameter(parameter.name); });
+
+    if (parameterList.empty()) {
+        logger(Level::warning) << "no search parameter given for database access\n";
+        return R"({"result": "illegal url given" })";
+    }
+
+    // several field parameters (e.g. album and performer) must all match
+    if (parameterList.size() > 1) {
+        std::vector<std::tuple<Database::SearchItem, std::string>> criteriaList;
+        for (const auto& [name, value] : parameterList) {
+            auto item = toSearchItem(name);
+            if (item == Database::SearchItem::unknown) {
+                logger(Level::warning) << "parameter <"<<name<<"> cannot be combined in database access\n";
+                return R"({"result": "illegal url given" })";
+            }
+            criteriaList.emplace_back(item, value);
+        }
+        if (page) {
+            auto list = database.findAudioItems(criteriaList, Database::SearchAction::exact, *page);
+            return toPageJson(convertToJson(list), list.nextCursor());
+        }
+        return convertToJson(database.findAudioItems(criteriaList, Database::SearchAction::exact));
+    }
+
+    auto& parameter = parameterList.at(0).name;
+    auto& value = parameterList.at(0).value;
     auto command = urlInfo->getCommand();
 
     logger(Level::info) << "database access cmd <"<<command<<"> parameter:<"<<parameter<<"> value:<"<<value<<">\n";
 
     if (parameter == ServerConstant::Command::getAlbumList) {
-        auto list = m_database->searchPlaylistItems(value, Database::SearchAction::alike);
+        // albums are given by name, if no other order is requested
+        auto albumPage = toPageRequest(urlInfo, Database::SortOrder::name).value_or(Database::PageRequest{0, 0, Database::SortOrder::name});
+        auto list = database.findPlaylistItems(value, Database::SearchAction::alike, albumPage);
 
         logger(Level::info) << "found a list of <"<<list.size()<< "> elements\n";
 
-        std::sort(std::begin(list), std::end(list), [](Database::Playlist& item1, Database::Playlist& item2) { return item1.getUniqueID() > item2.getUniqueID(); });
-
+        if (page)
+            return toPageJson(convertToJson(list), list.nextCursor());
         return convertToJson(list);
     }
 
+    auto findAudioItems = [this, &database, &page, &value](Database::SearchItem item) {
+        if (page) {
+            auto list = database.findAudioItems(value, item, Database::SearchAction::exact, *page);
+            return toPageJson(convertToJson(list), list.nextCursor());
+        }
+        return convertToJson(database.findAudioItems(value, item, Database::SearchAction::exact));
+    };
+
     if ( parameter == ServerConstant::Parameter::Database::overall )
-        return convertToJson(m_database->searchAudioItems(value, Database::SearchItem::overall, Database::SearchAction::exact));
+        return findAudioItems(Database::SearchItem::overall);
 
     if ( parameter == ServerConstant::Parameter::Database::performer )
-        return convertToJson(m_database->searchAudioItems(value, Database::SearchItem::performer, Database::SearchAction::exact));
+        return findAudioItems(Database::SearchItem::performer);
 
     if ( parameter == ServerConstant::Parameter::Database::title )
-        return convertToJson(m_database->searchAudioItems(value, Database::SearchItem::title, Database::SearchAction::exact));
+        return findAudioItems(Database::SearchItem::title);
 
     if ( parameter == ServerConstant::Parameter::Database::album )
-        return convertToJson(m_database->searchAudioItems(value, Database::SearchItem::album, Database::SearchAction::exact));
+        return findAudioItems(Database::SearchItem::album);
 
     if ( parameter == ServerConstant::Parameter::Database::uid ){
-        auto uidData = m_database->searchAudioItems(value, Database::SearchItem::uid , Database::SearchAction::uniqueId);
+        auto uidData = database.findAudioItems(value, Database::SearchItem::uid , Database::SearchAction::uniqueId);
         logger(Level::debug) << "audio item uid found <"<<uidData.size()<<"> elements\n";
         if (uidData.size()>0) {
             auto retJson = convertToJson(uidData);
@@ -130,7 +482,7 @@ std::string DatabaseAccess::access(const utility::Extractor::UrlInformation &url
     }
 
     if (parameter == ServerConstant::Parameter::Database::playlist ) {
-        auto plData = m_database->searchPlaylistItems(value);
+        auto plData = database.findPlaylistItems(value);
         logger(Level::debug) << "playlist uid found <"<<plData.size()<<"> elements\n";
         if (plData.size() > 0)
             return convertToJson(plData);
@@ -155,7 +507,7 @@ std::optional<std::vector<char> > DatabaseAccess::getVirtualFile(const std::stri
                 return std::nullopt;
             }
 
-            return m_database->getCover(std::move(uid));
+            return getDatabase()->getCover(std::move(uid));
         }
     }
     return std::nullopt;
@@ -4,19 +4,66 @@
 #include <optional>
 #include <vector>
 #include <string_view>
+#include <unordered_map>
+#include <map>
+#include <mutex>
 #include <boost/uuid/uuid_io.hpp>
 #include "database/SimpleDatabase.h"
+#include "database/playhistory.h"
+#include "responsecache.h"
 
 class DatabaseAccess
 {
     //Database::SimpleDatabase& m_database;
-    std::shared_ptr<Database::SimpleDatabase> m_database;
+    // readers work on the published version, writers publish a changed copy
+    std::shared_ptr<Database::Snapshot<Database::SimpleDatabase>> m_database;
+    // shared by all copies (e.g. the one of the playlist access)
+    std::shared_ptr<ResponseCache> m_responseCache;
+    std::shared_ptr<Database::PlayHistory> m_playHistory;
 
-    std::string convertToJson(const std::optional<std::vector<Id3Info>> list);
-    std::string convertToJson(const std::vector<Database::Playlist>& list);
+    // state of the last completion request per session id (given by the client)
+    struct CompletionSessions {
+        std::mutex mutex;
+        std::unordered_map<std::string, Database::CompletionIndex::State> stateList;
+    };
+    std::shared_ptr<CompletionSessions> m_completionSessions;
+    static constexpr std::size_t maxCompletionSessions { 64 };
+
+    std::string convertToJson(const Database::ResultList<Id3Info>& list);
+    std::string convertToJson(const Database::ResultList<Database::Playlist>& list);
 
     std::optional<std::string> extractUuidFromTarget(std::string_view target);
 
+    static Database::SearchItem toSearchItem(std::string_view parameter);
+
+    std::string complete(const utility::Extractor::UrlInformation &urlInfo);
+
+    // duplicate report is always given page by page
+    static constexpr std::size_t defaultDuplicatesLimit { 100 };
+    using DuplicateList = std::vector<std::tuple<Id3Info, std::vector<boost::uuids::uuid>>>;
+    // reports (per key) of one database generation, every page is taken from them instead of searching again
+    struct DuplicateReports {
+        std::mutex mutex;
+        uint64_t generation {0};
+        std::map<Database::DuplicateKey, std::shared_ptr<const DuplicateList>> reportList;
+    };
+    std::shared_ptr<DuplicateReports> m_duplicateReports;
+    std::shared_ptr<const DuplicateList> duplicateReport(const Database::SimpleDatabase& database, Database::DuplicateKey key);
+    std::string duplicates(const Database::SimpleDatabase& database, const utility::Extractor::UrlInformation &urlInfo);
+
+    // all facets, or the one given as value (performer, album or tag)
+    std::string facets(const Database::SimpleDatabase& database, const utility::Extractor::UrlInformation &urlInfo);
+
+    // added, modified and removed audio items and playlists since the generation given
+    std::string changesSince(const Database::SimpleDatabase& database, const utility::Extractor::UrlInformation &urlInfo);
+
+    // most or recently played audio items, the value is the number of items
+    static constexpr std::size_t defaultPlayedLimit { 20 };
+    std::string playedItems(const utility::Extractor::UrlInformation &urlInfo);
+
+    std::string find(const Database::SimpleDatabase& database, const utility::Extractor::UrlInformation &urlInfo);
+    std::string cacheStatistics();
+
     bool testUrlPath(std::string_view url, const std::string& path) {
         if (url.substr(0,2+path.length()) == "/"+path+"/")
             return true;
@@ -36,20 +83,59 @@ class DatabaseAccess
 
 public:
     DatabaseAccess() = delete;
-    DatabaseAccess(std::shared_ptr<Database::SimpleDatabase> simpleDatabase): m_database(simpleDatabase) {}
+    DatabaseAccess(std::shared_ptr<Database::SimpleDatabase> simpleDatabase)
+        : m_database(std::make_shared<Database::Snapshot<Database::SimpleDatabase>>(std::move(simpleDatabase))),
+          m_responseCache(std::make_shared<ResponseCache>()),
+          m_playHistory(std::make_shared<Database::PlayHistory>()),
+          m_completionSessions(std::make_shared<CompletionSessions>()),
+          m_duplicateReports(std::make_shared<DuplicateReports>()) {}
 
     std::string access(const utility::Extractor::UrlInformation &urlInfo);
 
-    std::string restAPIDefinition();
+    // the response of an unchanged database is taken from the cache, otherwise created from the same version and cached
+    template <typename Func>
+    std::string cachedResponse(std::string_view endpoint, const utility::Extractor::UrlInformation &urlInfo, Func&& createResponse) {
+        auto key = ResponseCache::createKey(endpoint, urlInfo);
+        auto database = getDatabase();
+        auto generation = database->generation();
+        if (auto response = m_responseCache->find(key, generation))
+            return *response;
+        auto response = createResponse(*database);
+        m_responseCache->insert(std::move(key), response, generation);
+        return response;
+    }
 
-    bool loadDatabase() { if (!m_database) return false; m_database->loadDatabase(); return true; }
+    // limit, cursor and sort of the request, nullopt if the full result is requested
+    static std::optional<Database::PageRequest> toPageRequest(const utility::Extractor::UrlInformation &urlInfo,
+                                                              Database::SortOrder defaultOrder = Database::SortOrder::unsorted);
+    static bool isPageParameter(std::string_view parameter);
+    // plain searches (no pages) are sent to the federated instances as well, all other requests are answered locally
+    static bool isFederated(const utility::Extractor::UrlInformation &urlInfo);
+    // a paged result is given as object with the items and the cursor of the next page
+    static std::string toPageJson(const std::string& listJson, std::optional<std::size_t> nextCursor);
+
+    std::string restAPIDefinition();
 
     std::optional<std::vector<char>> virtualImageHandler(const std::string_view& _target);
     std::optional<std::string> virtualAudioHandler(const std::string_view& _target);
     std::optional<std::string> virtualPlaylistHandler(const std::string_view& _target);
     std::optional<std::vector<char>> getVirtualFile(const std::string_view& target) const;
 
-    std::shared_ptr<Database::SimpleDatabase> getDatabase() { return m_database; }
+    // the current version, it stays valid (and unchanged) as long as it is held
+    std::shared_ptr<const Database::SimpleDatabase> getDatabase() const { return m_database->read(); }
+
+    // all changes of the database go here, the changed version is published after change returned
+    template <typename Func>
+    auto updateDatabase(Func&& change) { return m_database->update(std::forward<Func>(change)); }
+
+    bool loadDatabase() {
+        updateDatabase([](Database::SimpleDatabase& database) { database.loadDatabase(); });
+        m_playHistory->read();
+        return true;
+    }
+
+    // plays are logged here (kept apart from the database, a play does not create a new version)
+    Database::PlayHistory& playHistory() { return *m_playHistory; }
 
 };
 
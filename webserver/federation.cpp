@@ -0,0 +1,193 @@
+#include "federation.h"
+
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <boost/beast.hpp>
+#include <nlohmann/json.hpp>
+#include "common/Constants.h"
+#include "common/logger.h"
+#include "rankedmerge.h"
+
+using namespace LoggerFramework;
+using tcp = boost::asio::ip::tcp;
+namespace http = boost::beast::http;
+
+namespace {
+
+// results of one search, the reply is given when the last part is finished
+struct Gather {
+    RankedMerge merge;
+    std::size_t pending {0};
+    Federation::ReplyHandler replyHandler;
+
+    void finish() {
+        if (--pending == 0)
+            replyHandler(merge.dump());
+    }
+};
+
+// relative urls of a peer item are given from the root of the peer
+void makeAbsolute(nlohmann::json& item, const std::string& field, const std::string& peerUrl) {
+    auto url = item.find(field);
+    if (url == item.end() || !url->is_string())
+        return;
+    auto value = url->get<std::string>();
+    if (value.empty() || value.rfind(ServerConstant::httpprefix, 0) == 0 || value.rfind(ServerConstant::httpsprefix, 0) == 0)
+        return;
+    *url = peerUrl + (value.front() == '/' ? "" : "/") + value;
+}
+
+class PeerRequest : public std::enable_shared_from_this<PeerRequest> {
+
+public:
+    using FinishHandler = std::function<void(std::optional<std::string>&&)>;
+
+private:
+    tcp::resolver m_resolver;
+    boost::beast::tcp_stream m_stream;
+    boost::asio::steady_timer m_timer;
+    boost::beast::flat_buffer m_buffer;
+    http::request<http::empty_body> m_request;
+    http::response<http::string_body> m_response;
+    Federation::Peer& m_peer;
+    FinishHandler m_finishHandler;
+    bool m_finished { false };
+
+    void finish(std::optional<std::string>&& body) {
+        m_finished = true;
+        m_timer.cancel();
+        boost::beast::error_code ec;
+        m_stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+        m_finishHandler(std::move(body));
+    }
+
+    void fail(const std::string& reason) {
+        if (m_finished)
+            return;
+        logger(Level::warning) << "peer <" << m_peer.name() << "> " << reason << ", skipped for "
+                               << Federation::retryDelay.count() << "s\n";
+        m_peer.retryAfter = std::chrono::steady_clock::now() + Federation::retryDelay;
+        finish(std::nullopt);
+    }
+
+public:
+
+    PeerRequest(boost::asio::io_context& context, Federation::Peer& peer, const std::string& target, FinishHandler&& finishHandler)
+        : m_resolver(context), m_stream(context), m_timer(context),
+          m_request(http::verb::get, target, 11),
+          m_peer(peer), m_finishHandler(std::move(finishHandler)) {
+        m_request.set(http::field::host, m_peer.host);
+        m_request.set(std::string(ServerConstant::federationHeader), "1");
+    }
+
+    void run(std::chrono::milliseconds timeout) {
+
+        auto self { shared_from_this() };
+
+        m_timer.expires_after(timeout);
+        m_timer.async_wait([this, self](const boost::system::error_code& ec) {
+            if (ec)
+                return;
+            // the pending operation returns with an error
+            fail("does not answer in time");
+            m_resolver.cancel();
+            m_stream.cancel();
+        });
+
+        m_resolver.async_resolve(m_peer.host, m_peer.port, [this, self](const boost::system::error_code& ec, tcp::resolver::results_type results) {
+            if (m_finished)
+                return;
+            if (ec)
+                return fail("cannot be resolved: " + ec.message());
+
+            m_stream.async_connect(results, [this, self](const boost::system::error_code& ec, const tcp::endpoint&) {
+                if (m_finished)
+                    return;
+                if (ec)
+                    return fail("cannot be connected: " + ec.message());
+
+                http::async_write(m_stream, m_request, [this, self](const boost::system::error_code& ec, std::size_t) {
+                    if (m_finished)
+                        return;
+                    if (ec)
+                        return fail("cannot be requested: " + ec.message());
+
+                    http::async_read(m_stream, m_buffer, m_response, [this, self](const boost::system::error_code& ec, std::size_t) {
+                        if (m_finished)
+                            return;
+                        if (ec)
+                            return fail("gives no reply: " + ec.message());
+                        if (m_response.result() != http::status::ok)
+                            return fail("answers with status <" + std::to_string(m_response.result_int()) + ">");
+                        finish(std::move(m_response.body()));
+                    });
+                });
+            });
+        });
+    }
+};
+
+}
+
+Federation::Federation(boost::asio::io_context &context, const std::vector<std::string> &peerList, std::chrono::milliseconds timeout)
+    : m_context(context), m_timeout(timeout) {
+
+    for (const auto& peer : peerList) {
+        auto colon = peer.find_last_of(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == peer.size()) {
+            logger(Level::warning) << "peer <" << peer << "> is not given as host:port, ignored\n";
+            continue;
+        }
+        m_peerList.push_back({peer.substr(0, colon), peer.substr(colon + 1), {}});
+    }
+}
+
+void Federation::search(const std::string &target, std::string &&localReply, ReplyHandler &&replyHandler) {
+
+    // errors and other answers than result lists are not federated
+    auto localList = nlohmann::json::parse(localReply, nullptr, false);
+    if (!localList.is_array()) {
+        replyHandler(std::move(localReply));
+        return;
+    }
+
+    auto gather = std::make_shared<Gather>();
+    gather->replyHandler = std::move(replyHandler);
+    gather->merge.add(std::move(localList));
+    gather->pending = 1; //< the local part, finished when all peers are asked
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto& peer : m_peerList) {
+        if (now < peer.retryAfter) {
+            logger(Level::debug) << "peer <" << peer.name() << "> failed before, not asked\n";
+            continue;
+        }
+
+        ++gather->pending;
+        std::make_shared<PeerRequest>(m_context, peer, target, [gather, peerName = peer.name()](std::optional<std::string>&& body) {
+            if (body) {
+                auto list = nlohmann::json::parse(*body, nullptr, false);
+                if (list.is_array()) {
+                    auto peerUrl = std::string(ServerConstant::httpprefix) + peerName;
+                    for (auto& item : list) {
+                        if (!item.is_object())
+                            continue;
+                        makeAbsolute(item, ServerConstant::JsonField::audioUrl, peerUrl);
+                        makeAbsolute(item, ServerConstant::JsonField::imageUrl, peerUrl);
+                        makeAbsolute(item, ServerConstant::JsonField::cover, peerUrl);
+                        item[ServerConstant::JsonField::peer] = peerName;
+                    }
+                    logger(Level::debug) << "peer <" << peerName << "> gives <" << list.size() << "> items\n";
+                    gather->merge.add(std::move(list));
+                }
+                else {
+                    logger(Level::warning) << "peer <" << peerName << "> gives no result list\n";
+                }
+            }
+            gather->finish();
+        })->run(m_timeout);
+    }
+
+    gather->finish();
+}
@@ -0,0 +1,53 @@
+#ifndef FEDERATION_H
+#define FEDERATION_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <boost/asio.hpp>
+
+/*!
+ * \brief Federation sends a database search to the other audioserver instances (peers)
+ * of the config and merges their results with the local one.
+ * All peers are asked at the same time, a peer that does not answer within the timeout
+ * is given up. It is not asked again for a while, the reply is made of the results at
+ * hand. The results are ranked lists, every list is merged by rank (the first items of
+ * all instances, then the second ones, ...) when it arrives.
+ * Peers answer with their local result only (the request holds the federation header),
+ * so a search is never passed on twice. Urls of peer items are made absolute and the
+ * peer is given with the item.
+ */
+class Federation
+{
+public:
+    using ReplyHandler = std::function<void(std::string&&)>;
+
+    struct Peer {
+        std::string host;
+        std::string port;
+        std::chrono::steady_clock::time_point retryAfter; //< a failed peer is skipped until then
+        std::string name() const { return host + ":" + port; }
+    };
+
+    static constexpr std::chrono::seconds retryDelay { 30 };
+
+private:
+    boost::asio::io_context& m_context;
+    std::vector<Peer> m_peerList;
+    std::chrono::milliseconds m_timeout;
+
+public:
+    // peers are given as "host:port"
+    Federation(boost::asio::io_context& context, const std::vector<std::string>& peerList, std::chrono::milliseconds timeout);
+    Federation(const Federation&) = delete;
+    Federation& operator=(const Federation&) = delete;
+
+    bool enabled() const { return !m_peerList.empty(); }
+
+    // the reply handler is called once, when all peers answered or failed
+    void search(const std::string& target, std::string&& localReply, ReplyHandler&& replyHandler);
+
+};
+
+#endif // FEDERATION_H
@@ -170,3 +170,7 @@ std::string PlayerAccess::access(const utility::Extractor::UrlInformation &urlIn
 void PlayerAccess::setSongEndCB(SongEndCallback &&endfunc) {
     m_player->setSongEndCB(std::move(endfunc));
 }
+
+void PlayerAccess::setSongPlayedCB(SongPlayedCallback &&playedfunc) {
+    m_player->setSongPlayedCB(std::move(playedfunc));
+}
@@ -43,6 +43,7 @@ public:
     bool isPlaying() const { return m_player->isPlaying(); }
 
     void setSongEndCB(SongEndCallback&& endfunc);
+    void setSongPlayedCB(SongPlayedCallback&& playedfunc);
 
 
     void resetPlayer() const { m_player->resetPlayer(); }
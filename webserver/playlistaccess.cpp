@@ -39,8 +39,13 @@ std::string PlaylistAccess::add(const std::string &value) {
             return R"({"result": "cannot add <)" + value + "> to playlist <" + boost::uuids::to_string( *currentPlaylist ) + ">}";
         }
 
-        if (m_database.getDatabase()->addToPlaylistUID(*currentPlaylist, std::move(uniqueID))) {
-            m_database.getDatabase()->writeChangedPlaylists();
+        auto added = m_database.updateDatabase([&currentPlaylist, &uniqueID](Database::SimpleDatabase& database) {
+            if (!database.addToPlaylistUID(*currentPlaylist, std::move(uniqueID)))
+                return false;
+            database.writeChangedPlaylists();
+            return true;
+        });
+        if (added) {
             logger(Level::debug) << "adding audio file <" << value
                                  << "> to playlist ID <" << boost::uuids::to_string(*currentPlaylist)
                                  << ">\n";
@@ -54,11 +59,16 @@ std::string PlaylistAccess::add(const std::string &value) {
 }
 
 std::string PlaylistAccess::create(const std::string &value) {
-    auto ID = m_database.getDatabase()->createPlaylist(value, Database::Persistent::isPermanent);
+    auto ID = m_database.updateDatabase([&value](Database::SimpleDatabase& database) {
+        auto ID = database.createPlaylist(value, Database::Persistent::isPermanent);
+        if (ID && !ID->is_nil()) {
+            database.setCurrentPlaylistUniqueId(*ID);
+            database.writeChangedPlaylists();
+        }
+        return ID;
+    });
     if (ID && !ID->is_nil()) {
         logger(Level::info) << "create playlist with name <" << value << "> "<<"-> "<<*ID<<" \n";
-        m_database.getDatabase()->setCurrentPlaylistUniqueId(std::move(*ID));
-        m_database.getDatabase()->writeChangedPlaylists();
         return R"({"result": "ok"})";
     } else {
         logger(Level::warning) << "create playlist with name <" << value << "> failed, name is not new\n";
@@ -66,16 +76,18 @@ std::string PlaylistAccess::create(const std::string &value) {
     }
 }
 
-std::string PlaylistAccess::getAlbumList(const std::string &value) {
-    auto list = m_database.getDatabase()->searchPlaylistItems(value, Database::SearchAction::alike);
-
-    std::sort(std::begin(list), std::end(list), [](Database::Playlist& item1, Database::Playlist& item2) { return item1.getUniqueID() > item2.getUniqueID(); });
+std::string PlaylistAccess::getAlbumList(const Database::SimpleDatabase &database, const std::string &value, const std::optional<Database::PageRequest>& page) {
+    // albums are given by name, if no other order is requested
+    auto list = database.findPlaylistItems(value, Database::SearchAction::alike,
+                                                            page.value_or(Database::PageRequest{0, 0, Database::SortOrder::name}));
 
+    if (page)
+        return DatabaseAccess::toPageJson(convertToJson(list), list.nextCursor());
     return convertToJson(list);
 }
 
-std::string PlaylistAccess::getAlbumUid(const std::string &value) {
-    auto list = m_database.getDatabase()->searchPlaylistItems(value, Database::SearchAction::uniqueId);
+std::string PlaylistAccess::getAlbumUid(const Database::SimpleDatabase &database, const std::string &value) {
+    auto list = database.findPlaylistItems(value, Database::SearchAction::uniqueId);
 
     return convertToJson(list);
 }
@@ -100,7 +112,9 @@ std::string PlaylistAccess::change(const std::string &value) {
         m_player.stop();
         m_player.resetPlayer();
     }
-    m_database.getDatabase()->setCurrentPlaylistUniqueId(playlistList[0].getUniqueID());
+    m_database.updateDatabase([&playlistList](Database::SimpleDatabase& database) {
+        database.setCurrentPlaylistUniqueId(playlistList[0].getUniqueID());
+    });
 
     if (!m_player.hasPlayer() || m_player.setPlaylist(m_database.getDatabase()->getAlbumPlaylistAndNames()))
         return R"({"result": "ok"})";
@@ -109,7 +123,7 @@ std::string PlaylistAccess::change(const std::string &value) {
 
 }
 
-std::string PlaylistAccess::show(const std::string &value) {
+std::string PlaylistAccess::show(const Database::SimpleDatabase &database, const std::string &value) {
 
     boost::uuids::uuid playlistName;
 
@@ -120,23 +134,23 @@ std::string PlaylistAccess::show(const std::string &value) {
             playlistName = boost::uuids::uuid();
         }
     }
-    else if ( auto playlist = m_database.getDatabase()->getCurrentPlaylistUniqueID() ) {
+    else if ( auto playlist = database.getCurrentPlaylistUniqueID() ) {
         playlistName = *playlist;
     }
 
-    auto itemList = m_database.getDatabase()->getIdListOfItemsInPlaylistId(playlistName);
+    auto itemList = database.getIdListOfItemsInPlaylistId(playlistName);
 
     logger(Level::info) << "show (" << itemList.size() << ") elements for playlist <" << boost::uuids::to_string(playlistName) << ">\n";
     return convertToJson(itemList);
 
 }
 
-std::string PlaylistAccess::showLists(const std::string &value) {
+std::string PlaylistAccess::showLists(const Database::SimpleDatabase &database, const std::string &value) {
 
     boost::ignore_unused(value);
 
     logger(Level::info) << "show all playlists\n";
-    std::vector<std::pair<std::string, boost::uuids::uuid>> lists = m_database.getDatabase()->getAllPlaylists();
+    std::vector<std::pair<std::string, boost::uuids::uuid>> lists = database.getAllPlaylists();
     if (!lists.empty()) {
         logger(Level::debug) << "playlists are \n";
         nlohmann::json json;
@@ -150,8 +164,8 @@ std::string PlaylistAccess::showLists(const std::string &value) {
                 jsonList.push_back(jentry);
             }
             json[ServerConstant::JsonField::playlists] = jsonList;
-            if (auto currentPlaylistUniqueID = m_database.getDatabase()->getCurrentPlaylistUniqueID()) {
-                if (auto playlistRealname = m_database.getDatabase()->convertPlaylist(*currentPlaylistUniqueID))
+            if (auto currentPlaylistUniqueID = database.getCurrentPlaylistUniqueID()) {
+                if (auto playlistRealname = database.convertPlaylist(*currentPlaylistUniqueID))
                     json[ServerConstant::JsonField::currentPlaylist] = *playlistRealname;
                 else
                     json[ServerConstant::JsonField::currentPlaylist] = std::string("");
@@ -174,36 +188,34 @@ std::string PlaylistAccess::getCurrentPlaylistUID(const std::string &value) {
     return convertToJson(playlistUID);
 }
 
-std::string PlaylistAccess::convertToJson(const std::optional<std::vector<Id3Info>> list) {
+std::string PlaylistAccess::convertToJson(const Database::ResultList<Id3Info>& list) {
 
     nlohmann::json json;
 
     try {
-        if (list) {
-            for(auto item : *list) {
-                nlohmann::json jentry;
-                std::string urlAudioFile {item.urlAudioFile};
-                if (item.urlAudioFile.length() > ServerConstant::fileprefix.length() &&
-                        item.urlAudioFile.substr(0,ServerConstant::fileprefix.length()) == ServerConstant::fileprefix) {
-                    std::string extension = std::string(ServerConstant::mp3Extension);
-                    if (auto dotPos = item.urlAudioFile.find_last_of('.')) {
-                        if (dotPos != std::string::npos) {
-                          extension = item.urlAudioFile.substr(dotPos);
-                        }
+        for(const auto& item : list) {
+            nlohmann::json jentry;
+            std::string urlAudioFile {item.urlAudioFile};
+            if (item.urlAudioFile.length() > ServerConstant::fileprefix.length() &&
+                    item.urlAudioFile.substr(0,ServerConstant::fileprefix.length()) == ServerConstant::fileprefix) {
+                std::string extension = std::string(ServerConstant::mp3Extension);
+                if (auto dotPos = item.urlAudioFile.find_last_of('.')) {
+                    if (dotPos != std::string::npos) {
+                      extension = item.urlAudioFile.substr(dotPos);
                     }
-                    urlAudioFile = std::string(ServerConstant::audioPath) + "/" + boost::uuids::to_string(item.uid) + extension;
                 }
+                urlAudioFile = std::string(ServerConstant::audioPath) + "/" + boost::uuids::to_string(item.uid) + extension;
+            }
 
-                jentry[std::string(ServerConstant::JsonField::uid)] = boost::uuids::to_string(item.uid);
-                jentry[std::string(ServerConstant::JsonField::performer)] = item.performer_name;
-                jentry[std::string(ServerConstant::JsonField::album)] = item.album_name;
-                jentry[std::string(ServerConstant::JsonField::title)] = item.title_name;
-                jentry[std::string(ServerConstant::JsonField::cover)] = item.urlCoverFile;
-                jentry[std::string(ServerConstant::JsonField::trackNo)] = item.track_no;
-                jentry[std::string(ServerConstant::JsonField::url)] = urlAudioFile;
+            jentry[std::string(ServerConstant::JsonField::uid)] = boost::uuids::to_string(item.uid);
+            jentry[std::string(ServerConstant::JsonField::performer)] = item.performer_name;
+            jentry[std::string(ServerConstant::JsonField::album)] = item.album_name;
+            jentry[std::string(ServerConstant::JsonField::title)] = item.title_name;
+            jentry[std::string(ServerConstant::JsonField::cover)] = item.urlCoverFile;
+            jentry[std::string(ServerConstant::JsonField::trackNo)] = item.track_no;
+            jentry[std::string(ServerConstant::JsonField::url)] = urlAudioFile;
 
-                json.push_back(jentry);
-            }
+            json.push_back(std::move(jentry));
         }
     } catch (const std::exception& ex) {
         logger(Level::error) << "conversion to json failed: " << ex.what();
@@ -213,12 +225,12 @@ std::string PlaylistAccess::convertToJson(const std::optional<std::vector<Id3Inf
     return json.dump(2);
 }
 
-std::string PlaylistAccess::convertToJson(const std::vector<Database::Playlist> list) {
+std::string PlaylistAccess::convertToJson(const Database::ResultList<Database::Playlist>& list) {
 
     nlohmann::json json;
 
     try {
-        for(auto item : list) {
+        for(const auto& item : list) {
             nlohmann::json jentry;
 
             jentry[std::string(ServerConstant::JsonField::uid)] = boost::uuids::to_string(item.getUniqueID());
@@ -239,7 +251,10 @@ std::string PlaylistAccess::convertToJson(const std::vector<Database::Playlist>
 
 std::string PlaylistAccess::access(const utility::Extractor::UrlInformation &urlInfo) {
 
-    if (!urlInfo || urlInfo->m_parameterList.size() != 1) {
+    // the command comes first, it can only be followed by the paging parameters
+    if (!urlInfo || urlInfo->m_parameterList.empty() ||
+            !std::all_of(std::next(std::begin(urlInfo->m_parameterList)), std::end(urlInfo->m_parameterList),
+                         [](const utility::Parameter& parameter) { return DatabaseAccess::isPageParameter(parameter.name); })) {
         logger(Level::warning) << "invalid url given for database access\n";
         return R"({"result": "illegal url given" })";
     }
@@ -254,11 +269,13 @@ std::string PlaylistAccess::access(const utility::Extractor::UrlInformation &url
     }
 
     if (parameter == ServerConstant::Command::getAlbumList) {
-        return getAlbumList(value);
+        return m_database.cachedResponse("playlist", urlInfo, [this, &value, &urlInfo](const Database::SimpleDatabase& database) {
+            return getAlbumList(database, value, DatabaseAccess::toPageRequest(urlInfo, Database::SortOrder::name));
+        });
     }
 
     if (parameter == ServerConstant::Command::getAlbumUid) {
-        return getAlbumUid(value);
+        return m_database.cachedResponse("playlist", urlInfo, [this, &value](const Database::SimpleDatabase& database) { return getAlbumUid(database, value); });
     }
 
     /* change to new playlist */
@@ -271,12 +288,12 @@ std::string PlaylistAccess::access(const utility::Extractor::UrlInformation &url
     }
 
     if (parameter == ServerConstant::Command::show) {
-        return show(value);
+        return m_database.cachedResponse("playlist", urlInfo, [this, &value](const Database::SimpleDatabase& database) { return show(database, value); });
     }
 
     /* returns all playlist names */
     if (parameter == ServerConstant::Command::showLists) {
-        return showLists(value);
+        return m_database.cachedResponse("playlist", urlInfo, [this, &value](const Database::SimpleDatabase& database) { return showLists(database, value); });
     }
 
     if (parameter == ServerConstant::Command::currentPlaylistUID) {
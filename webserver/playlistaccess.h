@@ -14,17 +14,17 @@ class PlaylistAccess
     DatabaseAccess m_database;
     PlayerAccess m_player;
 
-    std::string convertToJson(const std::optional<std::vector<Id3Info>> list);
-    std::string convertToJson(const std::vector<Database::Playlist> list);
+    std::string convertToJson(const Database::ResultList<Id3Info>& list);
+    std::string convertToJson(const Database::ResultList<Database::Playlist>& list);
     std::string convertToJson(const std::optional<boost::uuids::uuid> actualPlaylistUuid);
 
     std::string add(const std::string& value);
     std::string create(const std::string& value);
-    std::string getAlbumList(const std::string& value);
-    std::string getAlbumUid(const std::string &value);
+    std::string getAlbumList(const Database::SimpleDatabase& database, const std::string& value, const std::optional<Database::PageRequest>& page);
+    std::string getAlbumUid(const Database::SimpleDatabase& database, const std::string &value);
     std::string change(const std::string& value);
-    std::string show(const std::string& value);
-    std::string showLists(const std::string& value);
+    std::string show(const Database::SimpleDatabase& database, const std::string& value);
+    std::string showLists(const Database::SimpleDatabase& database, const std::string& value);
     std::string getCurrentPlaylistUID(const std::string& value);
 
 public:
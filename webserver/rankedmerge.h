@@ -0,0 +1,64 @@
+#ifndef RANKEDMERGE_H
+#define RANKEDMERGE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+#include "common/Constants.h"
+
+/*!
+ * \brief RankedMerge merges the ranked result lists of several audioserver instances
+ * by rank, items of the same rank stay in the order of arrival.
+ * An audio item given before (same uid) is skipped, its uid is random, so it is the same
+ * item. Playlists are only skipped if given before by the same instance, as album
+ * playlist uids are made of the album name and are equal on every instance.
+ */
+class RankedMerge {
+
+    std::vector<std::pair<std::size_t, nlohmann::json>> m_itemList; //< rank and item, sorted by rank
+    std::unordered_set<std::string> m_keyList;
+
+    static std::string key(const nlohmann::json& item, const std::string& uid) {
+        if (item.contains(ServerConstant::JsonField::audioUrl))
+            return uid;
+        auto peer = item.find(ServerConstant::JsonField::peer);
+        return (peer != item.end() && peer->is_string() ? peer->get<std::string>() : std::string()) + "/" + uid;
+    }
+
+public:
+
+    void add(nlohmann::json&& list) {
+        std::vector<std::pair<std::size_t, nlohmann::json>> rankedList;
+        rankedList.reserve(list.size());
+        for (std::size_t rank{0}; rank < list.size(); ++rank) {
+            auto& item = list[rank];
+            auto uid = item.find(ServerConstant::JsonField::uid);
+            if (uid != item.end() && uid->is_string() && !m_keyList.insert(key(item, uid->get<std::string>())).second)
+                continue;
+            rankedList.emplace_back(rank, std::move(item));
+        }
+
+        std::vector<std::pair<std::size_t, nlohmann::json>> mergedList;
+        mergedList.reserve(m_itemList.size() + rankedList.size());
+        std::merge(std::make_move_iterator(std::begin(m_itemList)), std::make_move_iterator(std::end(m_itemList)),
+                   std::make_move_iterator(std::begin(rankedList)), std::make_move_iterator(std::end(rankedList)),
+                   std::back_inserter(mergedList),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+        m_itemList = std::move(mergedList);
+    }
+
+    nlohmann::json list() const {
+        nlohmann::json json = nlohmann::json::array();
+        for (const auto& [rank, item] : m_itemList)
+            json.push_back(item);
+        return json;
+    }
+
+    std::string dump() const { return list().dump(2); }
+};
+
+#endif // RANKEDMERGE_H
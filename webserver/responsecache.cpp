@@ -0,0 +1,59 @@
+#include "responsecache.h"
+#include "common/logger.h"
+
+using namespace LoggerFramework;
+
+bool ResponseCache::setGeneration(uint64_t generation) {
+    if (generation == m_generation)
+        return true;
+    // a reader of an older snapshot must not drop the responses of the current one
+    if (generation < m_generation)
+        return false;
+    if (!m_entries.empty())
+        logger(Level::debug) << "database changed, dropping <" << m_entries.size() << "> cached responses\n";
+    m_index.clear();
+    m_entries.clear();
+    m_generation = generation;
+    return true;
+}
+
+std::string ResponseCache::createKey(std::string_view endpoint, const utility::Extractor::UrlInformation &urlInfo) {
+    std::string key { endpoint };
+    for (const auto& [name, value] : urlInfo->m_parameterList)
+        key.append(1, '&').append(name).append(1, '=').append(value);
+    return key;
+}
+
+std::optional<std::string> ResponseCache::find(const std::string &key, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = setGeneration(generation) ? m_index.find(key) : std::end(m_index);
+    if (it == std::end(m_index)) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    ++m_hits;
+    m_entries.splice(std::begin(m_entries), m_entries, it->second);
+    return it->second->second;
+}
+
+void ResponseCache::insert(std::string &&key, const std::string &response, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (generation != m_generation || m_capacity == 0 || m_index.find(key) != std::end(m_index))
+        return;
+
+    if (m_entries.size() >= m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(std::move(key), response);
+    m_index.emplace(m_entries.front().first, std::begin(m_entries));
+}
+
+ResponseCache::Statistics ResponseCache::statistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return { m_hits, m_misses, m_entries.size(), m_capacity };
+}
@@ -0,0 +1,59 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+#include <unordered_map>
+
+#include "common/Extractor.h"
+
+/*!
+ * \brief ResponseCache keeps the serialized responses of the last requests (least
+ * recently used are dropped first). All responses belong to one database generation,
+ * a request with a newer generation drops them all, one with an older generation is
+ * not answered from the cache.
+ */
+class ResponseCache
+{
+public:
+    struct Statistics {
+        uint64_t hits {0};
+        uint64_t misses {0};
+        std::size_t entries {0};
+        std::size_t capacity {0};
+    };
+
+    static constexpr std::size_t defaultCapacity { 256 };
+
+private:
+    using Entry = std::pair<std::string, std::string>; //< key and response
+
+    std::size_t m_capacity;
+    uint64_t m_generation {0};
+    std::list<Entry> m_entries; //< most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index; //< key (held by the entry) to entry
+    uint64_t m_hits {0};
+    uint64_t m_misses {0};
+    mutable std::mutex m_mutex;
+
+    // only moves forward, false for an older generation
+    bool setGeneration(uint64_t generation);
+
+public:
+    explicit ResponseCache(std::size_t capacity = defaultCapacity) : m_capacity(capacity) {}
+
+    // endpoint and all parameters (including paging and sort order) of the request
+    static std::string createKey(std::string_view endpoint, const utility::Extractor::UrlInformation& urlInfo);
+
+    std::optional<std::string> find(const std::string& key, uint64_t generation);
+    // a response of an outdated generation is not stored
+    void insert(std::string&& key, const std::string& response, uint64_t generation);
+
+    Statistics statistics() const;
+};
+
+#endif // RESPONSECACHE_H
@@ -8,6 +8,16 @@ using namespace Common;
 bool SessionHandler::addUrlHandler(const std::string_view &path,
                                    http::verb method, PathCompare pathCompare,
                                    SessionHandler::RequestHandler &&handler)
+{
+    return addAsyncUrlHandler(path, method, pathCompare, [handler = std::move(handler)]
+                              (const http::request_parser<http::string_body>& request, ReplyHandler&& replyHandler) {
+        replyHandler(handler(request));
+    });
+}
+
+bool SessionHandler::addAsyncUrlHandler(const std::string_view &path,
+                                        http::verb method, PathCompare pathCompare,
+                                        SessionHandler::AsyncRequestHandler &&handler)
 {
     auto handlerIt = find(pathToStringHandler, path, method);
 
@@ -41,7 +51,7 @@ bool SessionHandler::addUploadHandler(const std::string_view &path,
     return true;
 }
 
-std::string SessionHandler::callHandler(http::request_parser<http::string_body> &requestHeader) const {
+void SessionHandler::callHandler(const http::request_parser<http::string_body> &requestHeader, ReplyHandler&& replyHandler) const {
 
     std::string_view path = requestHeader.get().target();
     const http::verb& method = requestHeader.get().method();
@@ -49,12 +59,13 @@ std::string SessionHandler::callHandler(http::request_parser<http::string_body>
     auto handlerIt = find(pathToStringHandler, path, method);
 
     if (handlerIt != pathToStringHandler.end()) {
-        auto& handler = std::get<RequestHandler>(*handlerIt);
-        return handler(requestHeader);
+        auto& handler = std::get<AsyncRequestHandler>(*handlerIt);
+        handler(requestHeader, std::move(replyHandler));
+        return;
     }
 
     logger(Level::warning) << "request to no endpoint found for <"<<requestHeader.get().target() <<">\n";
-    return "";
+    replyHandler("");
 }
 
 bool SessionHandler::isUploadFile(const http::request_parser<http::empty_body> &requestHeader) const {
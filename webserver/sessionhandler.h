@@ -22,12 +22,14 @@ class SessionHandler {
 
     using NameGeneratorFunction = std::function<const typename Common::NameGenerator::GenerationName (void)>;
     using RequestHandler = std::function<std::string(const http::request_parser<http::string_body>&)>;
+    using ReplyHandler = std::function<void(std::string&&)>;
+    using AsyncRequestHandler = std::function<void(const http::request_parser<http::string_body>&, ReplyHandler&&)>;
     using UploadFinishedHandler = std::function<bool(const Common::NameGenerator::GenerationName&)>;
     using VirtualImageHandler = std::function<std::optional<std::vector<char>>(const std::string_view&)>;
     using VirtualAudioHandler = std::function<std::optional<std::string>(const std::string_view&)>;
     using VirtualPlaylistHandler = std::function<std::optional<std::string>(const std::string_view&)>;
 
-    using StringHandlerElement = std::tuple<std::string_view, http::verb, PathCompare, RequestHandler>;
+    using StringHandlerElement = std::tuple<std::string_view, http::verb, PathCompare, AsyncRequestHandler>;
     using FileHandlerList = std::vector<std::tuple<std::string_view, http::verb, PathCompare, NameGeneratorFunction, UploadFinishedHandler>>;
     using StringHandlerList = std::vector<StringHandlerElement>;
 
@@ -78,6 +80,8 @@ public:
      * \return true, if REST accesspoint is met, false if not
      */
     bool addUrlHandler(const std::string_view& path, http::verb method, PathCompare pathCompare, RequestHandler&& handler);
+    // the handler gives its reply later (e.g. after asking other servers), the reply handler must be called exactly once
+    bool addAsyncUrlHandler(const std::string_view& path, http::verb method, PathCompare pathCompare, AsyncRequestHandler&& handler);
     bool addUploadHandler(const std::string_view& path, NameGeneratorFunction&& handler, UploadFinishedHandler&& finishHandler);
 
     bool addVirtualImageHandler(VirtualImageHandler&& handler) { m_virtualImageHander = std::move(handler); return true; }
@@ -102,7 +106,8 @@ public:
         return m_virtualPlaylistHander(target); // only delegation
     }
 
-    std::string callHandler(http::request_parser<http::string_body>& requestHeader) const;
+    // the reply is empty, if no handler is found
+    void callHandler(const http::request_parser<http::string_body>& requestHeader, ReplyHandler&& replyHandler) const;
     bool callFileUploadHandler(http::request_parser<http::file_body>& request, const Common::NameGenerator::GenerationName& name) const;
 
     std::string generateRESTInterfaceDocumentation();